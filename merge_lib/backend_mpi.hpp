@@ -0,0 +1,233 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "mpi_transport.hpp"
+
+namespace merge_lib {
+
+enum class mpi_mode {
+    gather,       // root собирает отсортированные блоки и сливает их сам
+    sample_sort,  // PSRS: один обмен MPI_Alltoallv, root только склеивает части
+    tree          // биномиальное дерево: ранги сливают серии друг с другом, root получает одну
+};
+
+// Распределённый бэкенд: root раздаёт блоки, каждый ранг сортирует свой блок
+// локальным бэкендом Local, дальше — по mode
+template <class Local = serial_backend>
+struct mpi_backend {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int root = 0;
+    Local local{};
+    mpi_mode mode = mpi_mode::gather;
+};
+
+// MPI_Init_thread для гибридного режима: MPI вызывает только главный поток
+// ранга (FUNNELED), остальные потоки лишь сортируют
+inline void init_thread(int* argc, char*** argv, int required = MPI_THREAD_FUNNELED) {
+    int provided;
+    MPI_Init_thread(argc, argv, required, &provided);
+    if (provided < required) {
+        std::fprintf(stderr, "MPI: нужный уровень поддержки потоков недоступен (%d < %d)\n",
+                     provided, required);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+// Раскладка ранги-на-узел x потоки-на-ранг
+struct node_layout {
+    int ranks_per_node = 1;
+    int threads_per_rank = 1;
+};
+
+// threads_per_rank <= 0: ядра узла делятся поровну между его рангами
+inline node_layout detect_layout(MPI_Comm comm = MPI_COMM_WORLD, int threads_per_rank = 0) {
+    MPI_Comm node;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+
+    node_layout layout;
+    MPI_Comm_size(node, &layout.ranks_per_node);
+    MPI_Comm_free(&node);
+
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    layout.threads_per_rank = threads_per_rank > 0
+        ? threads_per_rank
+        : std::max(1, cores / layout.ranks_per_node);
+    return layout;
+}
+
+// Разбиение n элементов на size почти равных блоков
+inline std::vector<std::size_t> block_partition(std::size_t n, int size) {
+    std::vector<std::size_t> counts(size);
+    for (int i = 0; i < size; i++)
+        counts[i] = n / size + ((std::size_t)i < n % size ? 1 : 0);
+    return counts;
+}
+
+// Слияние подряд идущих отсортированных серий data[bounds[i], bounds[i+1]) локальным бэкендом
+template <class Local, class T, class Compare>
+void merge_local_runs(Local& local, std::vector<T>& data, const std::vector<std::size_t>& bounds,
+                      const Params& p, Compare comp)
+{
+    std::size_t runs = bounds.size() - 1;
+    if (runs <= 1) return;
+
+    std::vector<T> tmp(data.size());
+    int depth = resolve_depth(p, local.concurrency());
+    local.run([&] {
+        merge_run_tree(local, data.data(), tmp.data(), bounds, 0, runs, depth, p, comp);
+    });
+}
+
+// Parallel sorting by regular sampling (PSRS). Каждый ранг передаёт свой блок local;
+// после возврата local отсортирован, и все элементы ранга i не больше элементов ранга i+1.
+template <class Local, class T, class Compare = std::less<T>>
+void sample_sort(std::vector<T>& local, mpi_backend<Local>& be, const Params& p = {}, Compare comp = {}) {
+    int rank, size;
+    MPI_Comm_rank(be.comm, &rank);
+    MPI_Comm_size(be.comm, &size);
+
+    // Этап 1: локальная сортировка
+    sort(local, be.local, p, comp);
+    if (size == 1) return;
+
+    // Этап 2: регулярная выборка — до size образцов с каждого ранга
+    std::size_t n = local.size();
+    int my_samples = (int)std::min<std::size_t>(size, n);
+    std::vector<T> samples(my_samples);
+    for (int i = 0; i < my_samples; i++)
+        samples[i] = local[i * n / my_samples];
+
+    std::vector<int> sample_counts(size), sample_displs(size, 0);
+    MPI_Allgather(&my_samples, 1, MPI_INT, sample_counts.data(), 1, MPI_INT, be.comm);
+    for (int i = 1; i < size; i++)
+        sample_displs[i] = sample_displs[i - 1] + sample_counts[i - 1];
+
+    std::vector<T> all_samples(sample_displs[size - 1] + sample_counts[size - 1]);
+    MPI_Allgatherv(samples.data(), my_samples, mpi_type<T>(),
+                   all_samples.data(), sample_counts.data(), sample_displs.data(), mpi_type<T>(), be.comm);
+    std::sort(all_samples.begin(), all_samples.end(), comp);
+
+    // Этап 3: size - 1 разделителей и разбиение своего блока
+    std::vector<std::size_t> send_counts(size, 0);
+    std::size_t prev = 0;
+    for (int i = 0; i < size; i++) {
+        std::size_t end = n;
+        if (i + 1 < size && !all_samples.empty()) {
+            const T& splitter = all_samples[(i + 1) * all_samples.size() / size];
+            end = std::upper_bound(local.begin() + prev, local.end(), splitter, comp) - local.begin();
+        }
+        send_counts[i] = end - prev;
+        prev = end;
+    }
+
+    // Этап 4: единственный обмен данными
+    std::vector<std::size_t> recv_counts(size);
+    MPI_Alltoall(send_counts.data(), 1, mpi_type<std::size_t>(),
+                 recv_counts.data(), 1, mpi_type<std::size_t>(), be.comm);
+    auto recv_displs = displacements(recv_counts);
+
+    std::vector<T> received(recv_displs[size - 1] + recv_counts[size - 1]);
+    alltoallv(local.data(), send_counts, received.data(), recv_counts, be.comm);
+
+    // Этап 5: слияние size отсортированных частей
+    std::vector<std::size_t> bounds(size + 1);
+    for (int i = 0; i < size; i++) bounds[i] = recv_displs[i];
+    bounds[size] = received.size();
+    merge_local_runs(be.local, received, bounds, p, comp);
+
+    local.swap(received);
+}
+
+constexpr int TAG_TREE_MERGE = 100;
+
+// Биномиальное дерево слияний по относительным рангам r = (rank - root) mod size:
+// на шаге k ранг r (кратный 2^(k+1)) принимает серию от r + 2^k и сливает со своей,
+// ранг r = 2^k (mod 2^(k+1)) отправляет свою серию r - 2^k и выходит.
+// Блоки рангов идут подряд, поэтому размер входящей серии известен заранее.
+// После возврата весь отсортированный массив лежит в local на root.
+template <class Local, class T, class Compare>
+void tree_merge(std::vector<T>& local, const std::vector<std::size_t>& counts, mpi_backend<Local>& be,
+                const Params& p, Compare comp)
+{
+    int rank, size;
+    MPI_Comm_rank(be.comm, &rank);
+    MPI_Comm_size(be.comm, &size);
+    int r = (rank - be.root + size) % size;
+
+    for (int step = 1; step < size; step *= 2) {
+        if (r % (2 * step) == step) {
+            int parent = (rank - step + size) % size;
+            send_vector(parent, TAG_TREE_MERGE, local, be.comm);
+            local.clear();
+            return;
+        }
+        if (r + step >= size) continue;
+
+        std::size_t incoming = 0;
+        for (int q = r + step; q < std::min(r + 2 * step, size); q++)
+            incoming += counts[(q + be.root) % size];
+
+        std::size_t own = local.size();
+        local.resize(own + incoming);
+        recv_into(local.data() + own, incoming, (rank + step) % size, TAG_TREE_MERGE, be.comm);
+
+        std::vector<std::size_t> bounds = {0, own, own + incoming};
+        merge_local_runs(be.local, local, bounds, p, comp);
+    }
+}
+
+// data значим только на root; после возврата root содержит отсортированный массив
+template <class Local, class T, class Compare = std::less<T>>
+void sort(std::vector<T>& data, mpi_backend<Local>& be, const Params& p = {}, Compare comp = {}) {
+    int rank, size;
+    MPI_Comm_rank(be.comm, &rank);
+    MPI_Comm_size(be.comm, &size);
+
+    unsigned long long n = (rank == be.root) ? data.size() : 0;
+    MPI_Bcast(&n, 1, MPI_UNSIGNED_LONG_LONG, be.root, be.comm);
+
+    std::vector<std::size_t> counts = block_partition(n, size);
+
+    // Этап 1: раздаём блоки
+    std::vector<T> local(counts[rank]);
+    scatterv(data.data(), counts, local.data(), be.root, be.comm);
+
+    if (be.mode == mpi_mode::sample_sort) {
+        sample_sort(local, be, p, comp);
+
+        // Части уже упорядочены между рангами: root только склеивает их
+        std::size_t my_count = local.size();
+        MPI_Allgather(&my_count, 1, mpi_type<std::size_t>(), counts.data(), 1, mpi_type<std::size_t>(), be.comm);
+        gatherv(local.data(), counts, data.data(), be.root, be.comm);
+        return;
+    }
+
+    // Этап 2: локальная сортировка
+    sort(local, be.local, p, comp);
+
+    if (be.mode == mpi_mode::tree) {
+        tree_merge(local, counts, be, p, comp);
+        if (rank == be.root) data.swap(local);
+        return;
+    }
+
+    // Этап 3: сбор на root и слияние
+    gatherv(local.data(), counts, data.data(), be.root, be.comm);
+
+    if (rank == be.root) {
+        std::vector<std::size_t> bounds = displacements(counts);
+        bounds.push_back(n);
+        merge_local_runs(be.local, data, bounds, p, comp);
+    }
+}
+
+} // namespace merge_lib
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <omp.h>
+
+namespace merge_lib {
+
+// Бэкенд на задачах OpenMP (нужен -fopenmp)
+struct omp_backend {
+    int threads = 0;  // 0 — omp_get_max_threads()
+
+    template <class F>
+    void run(F&& f) {
+        if (omp_in_parallel()) {
+            f();
+            return;
+        }
+        #pragma omp parallel num_threads(concurrency())
+        {
+            #pragma omp single
+            f();
+        }
+    }
+
+    template <class F, class G>
+    void invoke(F&& f, G&& g) {
+        auto* pf = &f;
+        #pragma omp task firstprivate(pf)
+        (*pf)();
+
+        g();
+
+        #pragma omp taskwait
+    }
+
+    int concurrency() const { return threads > 0 ? threads : omp_get_max_threads(); }
+};
+
+} // namespace merge_lib
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace merge_lib {
+
+// Бэкенд задаёт три операции:
+//   run(f)       — войти в параллельный регион и выполнить f
+//   invoke(f, g) — выполнить f и g (возможно параллельно) и дождаться обеих
+//   concurrency() — число потоков, на которое рассчитано дерево задач
+
+// Однопоточный бэкенд
+struct serial_backend {
+    template <class F>
+    void run(F&& f) { f(); }
+
+    template <class F, class G>
+    void invoke(F&& f, G&& g) {
+        f();
+        g();
+    }
+
+    int concurrency() const { return 1; }
+};
+
+} // namespace merge_lib
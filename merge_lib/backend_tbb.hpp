@@ -0,0 +1,35 @@
+#pragma once
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+namespace merge_lib {
+
+// Бэкенд на tbb::task_group (нужен -ltbb)
+struct tbb_backend {
+    int threads = 0;  // 0 — текущая арена TBB
+
+    template <class F>
+    void run(F&& f) {
+        if (threads <= 0) {
+            f();
+            return;
+        }
+        tbb::task_arena arena(threads);
+        arena.execute([&] { f(); });
+    }
+
+    template <class F, class G>
+    void invoke(F&& f, G&& g) {
+        tbb::task_group tg;
+        tg.run([&] { f(); });
+        g();
+        tg.wait();
+    }
+
+    int concurrency() const {
+        return threads > 0 ? threads : tbb::this_task_arena::max_concurrency();
+    }
+};
+
+} // namespace merge_lib
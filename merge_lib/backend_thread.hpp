@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "thread_pool.hpp"
+#include "work_stealing.hpp"
+
+namespace merge_lib {
+
+// Бэкенд на std::thread с кражей работы: левая половина кладётся в дек
+// текущего потока, правая выполняется сразу; свободные потоки крадут
+// самые старые (крупные) задачи у других
+struct thread_backend {
+    work_stealing_pool* pool = &work_stealing_pool::global();
+
+    template <class F>
+    void run(F&& f) { pool->run(f); }
+
+    template <class F, class G>
+    void invoke(F&& f, G&& g) {
+        if (!pool->inside()) {
+            f();
+            g();
+            return;
+        }
+
+        ws_task task;
+        task.fn = [](void* arg) { (*static_cast<F*>(arg))(); };
+        task.arg = &f;
+        pool->spawn(&task);
+
+        g();
+
+        pool->wait(&task);
+    }
+
+    int concurrency() const { return pool->size(); }
+};
+
+// Бэкенд на постоянном пуле с общей очередью: левая половина отправляется
+// в пул, правую выполняет текущий поток, затем помогает пулу, пока левая не готова
+struct pool_backend {
+    thread_pool* pool = &thread_pool::global();
+
+    template <class F>
+    void run(F&& f) { f(); }
+
+    template <class F, class G>
+    void invoke(F&& f, G&& g) {
+        std::atomic<bool> done{false};
+        pool->submit([&] {
+            f();
+            done.store(true, std::memory_order_release);
+        });
+
+        g();
+
+        while (!done.load(std::memory_order_acquire)) {
+            if (!pool->try_run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    int concurrency() const { return pool->size() + 1; }
+};
+
+} // namespace merge_lib
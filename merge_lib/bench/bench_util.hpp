@@ -0,0 +1,181 @@
+#pragma once
+
+// Общее для программ замеров: входные распределения, статистика по повторам,
+// вывод таблицей markdown, CSV или JSON.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---- Входные данные ----
+
+const std::vector<std::string> kDistributions = {
+    "uniform", "sorted", "reverse", "sawtooth", "few_unique", "extremes", "zipf"};
+
+// n ключей типа T. sawtooth — 16 возрастающих зубцов, few_unique — 10 значений
+// (как rand() % 10 в merge_thread.cpp), extremes — min(), -1, 0, 1, max() типа T
+// (крайние ключи в выборке few_unique.hpp), zipf — ранги 1..n с вероятностью ~ 1/ранг
+template <class T>
+std::vector<T> make_input(const std::string& dist, std::size_t n, std::uint64_t seed = 42) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> a(n);
+    std::uniform_int_distribution<T> any(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+
+    if (dist == "uniform" || dist == "sorted" || dist == "reverse") {
+        for (auto& x : a) x = any(gen);
+        if (dist != "uniform") std::sort(a.begin(), a.end());
+        if (dist == "reverse") std::reverse(a.begin(), a.end());
+    } else if (dist == "sawtooth") {
+        std::size_t tooth = std::max<std::size_t>(1, n / 16);
+        for (std::size_t i = 0; i < n; i++) a[i] = (T)(i % tooth);
+    } else if (dist == "few_unique") {
+        for (auto& x : a) x = (T)(gen() % 10);
+    } else if (dist == "extremes") {
+        const T keys[] = {std::numeric_limits<T>::min(), (T)-1, 0, 1, std::numeric_limits<T>::max()};
+        for (auto& x : a) x = keys[gen() % 5];
+    } else if (dist == "zipf") {
+        // Обратная функция распределения по префиксным суммам 1/k
+        std::size_t m = std::max<std::size_t>(1, std::min<std::size_t>(n, 1 << 20));
+        std::vector<double> cdf(m);
+        double sum = 0;
+        for (std::size_t k = 0; k < m; k++) cdf[k] = sum += 1.0 / (k + 1);
+        std::uniform_real_distribution<double> u(0, sum);
+        for (auto& x : a) x = (T)(std::lower_bound(cdf.begin(), cdf.end(), u(gen)) - cdf.begin());
+    } else {
+        std::cerr << "неизвестное распределение: " << dist << "\n";
+        std::exit(1);
+    }
+    return a;
+}
+
+// ---- Статистика ----
+
+struct stats {
+    double median = 0, min = 0, stddev = 0;
+};
+
+inline stats summarize(std::vector<double> t) {
+    stats s;
+    if (t.empty()) return s;
+    std::sort(t.begin(), t.end());
+    std::size_t k = t.size();
+    s.min = t.front();
+    s.median = k % 2 ? t[k / 2] : (t[k / 2 - 1] + t[k / 2]) / 2;
+    double mean = 0;
+    for (double x : t) mean += x / k;
+    for (double x : t) s.stddev += (x - mean) * (x - mean) / k;
+    s.stddev = std::sqrt(s.stddev);
+    return s;
+}
+
+// ---- Результаты ----
+
+// Строка результата: упорядоченные поля «имя — значение»
+struct record {
+    std::vector<std::pair<std::string, std::string>> fields;
+
+    template <class V>
+    record& add(const std::string& name, const V& value) {
+        std::ostringstream ss;
+        ss << value;
+        fields.emplace_back(name, ss.str());
+        return *this;
+    }
+};
+
+// Конечное десятичное число: strtod принял бы и inf, nan, 0x1p3 — в JSON это не числа
+inline bool is_number(const std::string& s) {
+    if (s.empty() || s.find_first_not_of("0123456789+-.eE") != std::string::npos) return false;
+    std::size_t d = s[0] == '-' ? 1 : 0;   // JSON: без + и точки в начале
+    if (d >= s.size() || !std::isdigit((unsigned char)s[d])) return false;
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    return end == s.c_str() + s.size() && std::isfinite(v);
+}
+
+// Так operator<< печатает бесконечность и NaN; в JSON — null
+inline bool is_non_finite(const std::string& s) {
+    return s == "inf" || s == "-inf" || s == "nan" || s == "-nan";
+}
+
+// format: table (markdown, как в *.md репозитория), csv, json
+inline void write(std::ostream& out, const std::vector<record>& rows, const std::string& format) {
+    if (rows.empty()) return;
+    const auto& head = rows.front().fields;
+
+    if (format == "json") {
+        out << "[\n";
+        for (std::size_t r = 0; r < rows.size(); r++) {
+            out << "  {";
+            for (std::size_t i = 0; i < rows[r].fields.size(); i++) {
+                const auto& f = rows[r].fields[i];
+                out << (i ? ", " : "") << "\"" << f.first << "\": ";
+                if (is_number(f.second)) out << f.second;
+                else if (is_non_finite(f.second)) out << "null";
+                else out << "\"" << f.second << "\"";
+            }
+            out << "}" << (r + 1 < rows.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+        return;
+    }
+
+    const char* sep = format == "csv" ? "," : " | ";
+    auto line = [&](auto&& cell) {
+        if (format != "csv") out << "| ";
+        for (std::size_t i = 0; i < head.size(); i++) out << (i ? sep : "") << cell(i);
+        out << (format != "csv" ? " |\n" : "\n");
+    };
+    line([&](std::size_t i) { return head[i].first; });
+    if (format != "csv") line([](std::size_t) { return std::string(":---:"); });
+    for (const auto& r : rows) line([&](std::size_t i) { return r.fields[i].second; });
+}
+
+// ---- Аргументы ----
+
+// --name value; без значения — "1"
+inline std::map<std::string, std::string> parse_args(int argc, char** argv) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string key = argv[i];
+        if (key.rfind("--", 0) != 0) continue;
+        bool has_value = i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0;
+        args[key.substr(2)] = has_value ? argv[++i] : "1";
+    }
+    return args;
+}
+
+inline std::vector<std::string> split(const std::string& s, char sep = ',') {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, sep))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+// "1e6", "2000000", "2^20"
+inline std::size_t parse_size(const std::string& s) {
+    std::size_t caret = s.find('^');
+    if (caret != std::string::npos)
+        return (std::size_t)std::pow(std::stod(s.substr(0, caret)), std::stod(s.substr(caret + 1)));
+    return (std::size_t)std::stod(s);
+}
+
+} // namespace bench
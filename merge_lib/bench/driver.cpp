@@ -0,0 +1,270 @@
+// Единый драйвер замеров: движки x размеры x потоки x распределения x ключи.
+//
+//   g++ -O2 -mavx2 -fopenmp -pthread driver.cpp -o driver
+//   g++ -O2 -mavx2 -fopenmp -pthread -DBENCH_TBB driver.cpp -o driver -ltbb
+//   mpicxx -O2 -mavx2 -fopenmp -DBENCH_MPI driver.cpp -o driver_mpi
+//
+//   ./driver --engines omp,radix,std --sizes 1e6,1e7 --threads 1,2,4 --reps 5
+//            --dists uniform,sorted,zipf --keys 32,64 --format csv --out run.csv
+//   mpirun -np 4 ./driver_mpi --engines mpi_gather,mpi_sample,mpi_tree --threads 1
+//
+// Время — медиана, минимум и стандартное отклонение по --reps повторам
+// (копия входа не входит в замер). GB/s — n * sizeof(ключ) / медиана.
+// path — каким путём прошла merge_lib::sort (merge / counting, см. few_unique.hpp).
+//
+// С -DMERGE_LIB_TRACE и --trace файл.json последний повтор каждой конфигурации
+// трассируется (см. trace.hpp): файл перезаписывается, сводка идёт в stderr.
+
+#include <omp.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../merge_sort.hpp"
+#include "../backend_omp.hpp"
+#include "../backend_thread.hpp"
+#include "../radix_sort.hpp"
+#include "../tuning.hpp"
+
+#ifdef BENCH_TBB
+#include "../backend_tbb.hpp"
+#endif
+
+#ifdef BENCH_MPI
+#include "../backend_mpi.hpp"
+#endif
+
+const char* kEngines =
+    "std, stable, serial, thread, pool, omp, natural, radix"
+#ifdef BENCH_TBB
+    ", tbb"
+#endif
+#ifdef BENCH_MPI
+    ", mpi_gather, mpi_sample, mpi_tree"
+#endif
+    ;
+
+int g_rank = 0, g_ranks = 1;
+std::string g_trace;   // --trace: куда писать Chrome trace
+bool g_tuned = false;  // --tuned: Params из профиля tuning.hpp
+
+template <class T>
+using sorter = std::function<std::string(std::vector<T>&)>;
+
+template <class T, class Backend>
+sorter<T> merge_sorter(std::shared_ptr<Backend> be, merge_lib::Params p) {
+    return [be, p](std::vector<T>& a) { return std::string(merge_lib::to_string(merge_lib::sort(a, *be, p))); };
+}
+
+// Движок name на threads потоках; пулы создаются здесь, вне замера
+template <class T>
+sorter<T> make_sorter(const std::string& name, int threads, const merge_lib::Params& params) {
+    using namespace merge_lib;
+    Params p = g_tuned ? tuned_params<T>(name, threads, params) : params;
+
+    if (name == "std")
+        return [](std::vector<T>& a) { std::sort(a.begin(), a.end()); return std::string("-"); };
+    if (name == "stable")
+        return [](std::vector<T>& a) { std::stable_sort(a.begin(), a.end()); return std::string("-"); };
+    if (name == "serial")
+        return merge_sorter<T>(std::make_shared<serial_backend>(), p);
+
+    if (name == "thread") {
+        auto pool = std::make_shared<work_stealing_pool>(threads);
+        auto be = std::make_shared<thread_backend>();
+        be->pool = pool.get();
+        auto run = merge_sorter<T>(be, p);
+        return [pool, run](std::vector<T>& a) { return run(a); };
+    }
+    if (name == "pool") {
+        auto pool = std::make_shared<thread_pool>(threads - 1);
+        auto be = std::make_shared<pool_backend>();
+        be->pool = pool.get();
+        auto run = merge_sorter<T>(be, p);
+        return [pool, run](std::vector<T>& a) { return run(a); };
+    }
+
+    auto omp = std::make_shared<omp_backend>();
+    omp->threads = threads;
+    if (name == "omp")
+        return merge_sorter<T>(omp, p);
+    if (name == "natural") {
+        Params np = p;
+        np.leaf_algo = leaf_kind::natural;
+        return merge_sorter<T>(omp, np);
+    }
+    if (name == "radix")
+        return [omp](std::vector<T>& a) { radix_sort(a, *omp); return std::string("radix"); };
+
+#ifdef BENCH_TBB
+    if (name == "tbb") {
+        auto be = std::make_shared<tbb_backend>();
+        be->threads = threads;
+        return merge_sorter<T>(be, p);
+    }
+#endif
+
+#ifdef BENCH_MPI
+    if (name.rfind("mpi_", 0) == 0) {
+        auto be = std::make_shared<mpi_backend<omp_backend>>();
+        be->local.threads = threads;
+        be->mode = name == "mpi_sample" ? mpi_mode::sample_sort
+                 : name == "mpi_tree"   ? mpi_mode::tree
+                                        : mpi_mode::gather;
+        return [be, p](std::vector<T>& a) { merge_lib::sort(a, *be, p); return std::string("mpi"); };
+    }
+#endif
+
+    if (g_rank == 0) std::cerr << "неизвестный движок: " << name << " (есть: " << kEngines << ")\n";
+    std::exit(1);
+}
+
+template <class T>
+void run_all(const std::vector<std::string>& engines, const std::vector<std::size_t>& sizes,
+             const std::vector<int>& thread_counts, const std::vector<std::string>& dists,
+             int reps, const merge_lib::Params& p, std::vector<bench::record>& rows)
+{
+    for (const auto& dist : dists) {
+        for (std::size_t n : sizes) {
+            // Данные значимы только на root (для MPI-движков), остальные получают пустой вектор
+            std::vector<T> input = g_rank == 0 ? bench::make_input<T>(dist, n) : std::vector<T>();
+            // Эталон для столбца ok: потерянный или продублированный элемент не пройдёт
+            std::vector<T> expected = input;
+            std::sort(expected.begin(), expected.end());
+
+            for (const auto& engine : engines) {
+                bool threaded = engine != "std" && engine != "stable" && engine != "serial";
+                for (int threads : thread_counts) {
+                    if (!threaded && threads != thread_counts.front()) continue;
+
+                    sorter<T> sort = make_sorter<T>(engine, threads, p);
+                    std::vector<double> times;
+                    std::string path;
+                    bool ok = true;
+
+                    for (int r = 0; r < reps; r++) {
+                        std::vector<T> a = input;
+#ifdef BENCH_MPI
+                        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+                        bool traced = !g_trace.empty() && r == reps - 1;
+                        if (traced) merge_lib::trace::start();
+                        double t0 = bench::now();
+                        path = sort(a);
+                        times.push_back(bench::now() - t0);
+                        if (traced) merge_lib::trace::stop();
+                        if (g_rank == 0) ok = ok && a == expected;
+                    }
+
+                    if (!g_trace.empty() && g_rank == 0) {
+                        std::cerr << "-- трасса " << engine << " " << dist << " " << n << " x" << threads << "\n";
+                        merge_lib::trace::print_summary(std::cerr);
+                        merge_lib::trace::write_chrome(g_trace);
+                    }
+
+                    bench::stats s = bench::summarize(times);
+                    bench::record row;
+                    row.add("engine", engine)
+                       .add("keys", sizeof(T) * 8)
+                       .add("dist", dist)
+                       .add("n", n)
+                       .add("threads", threaded ? threads : 1)
+                       .add("ranks", g_ranks)
+                       .add("reps", reps)
+                       .add("median_s", s.median)
+                       .add("min_s", s.min)
+                       .add("stddev_s", s.stddev)
+                       .add("melem_s", n / s.median / 1e6)
+                       .add("gb_s", n * sizeof(T) / s.median / 1e9)
+                       .add("path", path)
+                       .add("ok", ok ? "yes" : "no");
+                    rows.push_back(row);
+                    if (g_rank == 0) std::cerr << engine << " " << dist << " " << n << " x" << threads
+                                               << ": " << s.median << " s\n";
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+#ifdef BENCH_MPI
+    merge_lib::init_thread(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &g_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &g_ranks);
+#endif
+
+    auto args = bench::parse_args(argc, argv);
+    auto get = [&](const std::string& key, const std::string& def) {
+        return args.count(key) ? args[key] : def;
+    };
+    if (args.count("help")) {
+        std::cout << "--engines " << kEngines << "\n"
+                  << "--sizes 1e6,2^24   --threads 1,2,4   --reps 5   --keys 32,64\n"
+                  << "--dists uniform,sorted,reverse,sawtooth,few_unique,extremes,zipf\n"
+                  << "--format table|csv|json   --out файл   --cutoff N   --no-few-unique\n"
+                  << "--trace файл.json (нужна сборка с -DMERGE_LIB_TRACE)\n"
+                  << "--tuned — cutoff, глубина и лист из профиля (bench/tune.cpp)\n";
+        return 0;
+    }
+
+#ifdef BENCH_MPI
+    std::string default_engines = "mpi_gather,mpi_sample,mpi_tree";
+#else
+    std::string default_engines = "std,omp,radix";
+#endif
+    std::vector<std::string> engines = bench::split(get("engines", default_engines));
+    std::vector<std::string> dists = bench::split(get("dists", "uniform"));
+    std::vector<std::size_t> sizes;
+    for (auto& s : bench::split(get("sizes", "2e6"))) sizes.push_back(bench::parse_size(s));
+    std::vector<int> thread_counts;
+    for (auto& s : bench::split(get("threads", std::to_string(omp_get_max_threads()))))
+        thread_counts.push_back(std::stoi(s));
+    int reps = std::stoi(get("reps", "5"));
+
+    merge_lib::Params p;
+    if (args.count("cutoff")) p.cutoff = bench::parse_size(args["cutoff"]);
+    if (args.count("no-few-unique")) p.few_unique = false;
+    g_tuned = args.count("tuned");
+    if (args.count("trace")) {
+        if (merge_lib::trace::compiled)
+            g_trace = args["trace"];
+        else if (g_rank == 0)
+            std::cerr << "--trace игнорируется: сборка без -DMERGE_LIB_TRACE\n";
+    }
+
+    std::vector<std::string> key_sizes = bench::split(get("keys", "32"));
+    for (auto& keys : key_sizes)
+        if (keys != "32" && keys != "64") {
+            if (g_rank == 0) std::cerr << "неизвестный размер ключа: " << keys << " (есть: 32,64)\n";
+            std::exit(1);
+        }
+
+    std::vector<bench::record> rows;
+    for (auto& keys : key_sizes) {
+        if (keys == "64")
+            run_all<std::int64_t>(engines, sizes, thread_counts, dists, reps, p, rows);
+        else
+            run_all<std::int32_t>(engines, sizes, thread_counts, dists, reps, p, rows);
+    }
+
+    if (g_rank == 0) {
+        std::string format = get("format", "table");
+        if (args.count("out")) {
+            std::ofstream out(args["out"]);
+            bench::write(out, rows, format);
+        } else {
+            bench::write(std::cout, rows, format);
+        }
+    }
+
+#ifdef BENCH_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
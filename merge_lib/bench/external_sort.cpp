@@ -0,0 +1,114 @@
+// Внешняя сортировка файла больше бюджета памяти: генерация, сортировка, проверка.
+// g++ -O2 -fopenmp external_sort.cpp -o external_sort
+// ./external_sort [int32|int64] [N] [бюджет MiB] [каталог для серий]
+// ./external_sort check [каталог] — малые бюджеты (байты и КиБ), меньше блока ввода-вывода
+
+#include <omp.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../external_sort.hpp"
+#include "../backend_omp.hpp"
+
+template <class T>
+void generate(const std::string& path, std::size_t n) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    std::mt19937_64 gen(42);
+    std::vector<T> block(1 << 20);
+    for (std::size_t done = 0; done < n; done += block.size()) {
+        std::size_t k = std::min(block.size(), n - done);
+        for (std::size_t i = 0; i < k; i++) block[i] = (T)gen();
+        std::fwrite(block.data(), sizeof(T), k, f);
+    }
+    std::fclose(f);
+}
+
+// Файл отсортирован и содержит n элементов
+template <class T>
+bool check(const std::string& path, std::size_t n) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    std::vector<T> block(1 << 20);
+    std::size_t total = 0;
+    bool ok = true, first = true;
+    T prev{};
+    std::size_t k;
+    while ((k = std::fread(block.data(), sizeof(T), block.size(), f)) > 0) {
+        for (std::size_t i = 0; i < k; i++) {
+            if (!first && block[i] < prev) ok = false;
+            prev = block[i];
+            first = false;
+        }
+        total += k;
+    }
+    std::fclose(f);
+    return ok && total == n;
+}
+
+template <class T>
+void run(std::size_t n, std::size_t budget_mib, const std::string& dir) {
+    std::string in = dir + "/ext_in.bin", out = dir + "/ext_out.bin";
+    generate<T>(in, n);
+
+    merge_lib::omp_backend be;
+    merge_lib::ExternalParams ep;
+    ep.memory_budget = budget_mib << 20;
+    ep.tmp_dir = dir;
+
+    double start = omp_get_wtime();
+    merge_lib::external_sort<T>(in, out, be, ep);
+    double t = omp_get_wtime() - start;
+
+    double mib = double(n) * sizeof(T) / (1 << 20);
+    std::cout << "Элементов: " << n << " (" << sizeof(T) * 8 << " бит, " << mib << " MiB)\n"
+              << "Бюджет: " << budget_mib << " MiB, серий: "
+              << (n * sizeof(T) + (ep.memory_budget / 2) - 1) / (ep.memory_budget / 2) << "\n"
+              << "Время: " << t << " сек, " << mib / t << " MiB/s\n"
+              << (check<T>(out, n) ? "OK" : "ОШИБКА: файл не отсортирован") << std::endl;
+
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+}
+
+// Бюджет меньше 2 * min_block: блок уменьшается, слияние идёт по 2+ серии за проход
+template <class T>
+bool check_budget(std::size_t n, std::size_t budget, const std::string& dir) {
+    std::string in = dir + "/ext_in.bin", out = dir + "/ext_out.bin";
+    generate<T>(in, n);
+
+    merge_lib::omp_backend be;
+    merge_lib::ExternalParams ep;
+    ep.memory_budget = budget;
+    ep.tmp_dir = dir;
+    merge_lib::external_sort<T>(in, out, be, ep);
+
+    bool ok = check<T>(out, n);
+    std::cout << sizeof(T) * 8 << " бит, " << n << " элементов, бюджет " << budget << " байт: "
+              << (ok ? "OK" : "ОШИБКА") << std::endl;
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    std::string type = argc > 1 ? argv[1] : "int32";
+    if (type == "check") {
+        std::string dir = argc > 2 ? argv[2] : ".";
+        bool ok = check_budget<std::int64_t>(100000, 4 << 10, dir)
+               && check_budget<std::int32_t>(100000, 1 << 10, dir)
+               && check_budget<std::int64_t>(1000, 64, dir)
+               && check_budget<std::int32_t>(1000000, (2 << 20) - 1, dir);
+        return ok ? 0 : 1;
+    }
+    std::size_t n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000000;
+    std::size_t budget = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+    std::string dir = argc > 4 ? argv[4] : ".";
+
+    if (type == "int64") run<std::int64_t>(n, budget, dir);
+    else run<std::int32_t>(n, budget, dir);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Записи (uint64 ключ + данные): сортировка с перемещением записей
+// против режима ключ/индекс с одной перестановкой в конце.
+// g++ -O2 -fopenmp key_sort.cpp -o key_sort
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../key_sort.hpp"
+#include "../backend_omp.hpp"
+
+template <std::size_t Bytes>
+struct Record {
+    std::uint64_t key;
+    char payload[Bytes - sizeof(std::uint64_t)];
+};
+
+template <std::size_t Bytes>
+void run(std::size_t n, int reps) {
+    using R = Record<Bytes>;
+    std::mt19937_64 gen(42);
+    std::vector<R> data(n);
+    for (auto& r : data) r.key = gen();
+
+    auto key = [](const R& r) { return r.key; };
+    merge_lib::omp_backend be;
+
+    auto measure = [&](auto&& fn) {
+        double best = 1e30;
+        for (int i = 0; i < reps; i++) {
+            std::vector<R> a = data;
+            double start = omp_get_wtime();
+            fn(a);
+            best = std::min(best, omp_get_wtime() - start);
+        }
+        return best;
+    };
+
+    double t_std = measure([&](std::vector<R>& a) {
+        std::stable_sort(a.begin(), a.end(), [](const R& x, const R& y) { return x.key < y.key; });
+    });
+    double t_by = measure([&](std::vector<R>& a) { merge_lib::sort_by(a, be, key); });
+    double t_key = measure([&](std::vector<R>& a) { merge_lib::sort_by_key(a, be, key); });
+
+    std::cout << "| " << Bytes << " | " << t_std << " | " << t_by << " | " << t_key << " |\n";
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int reps = 3;
+
+    std::cout << "| Запись (байт) | std::stable_sort | sort_by | sort_by_key |\n"
+              << "| :-----------: | :--------------: | :-----: | :---------: |\n";
+    run<16>(n, reps);
+    run<64>(n, reps);
+    run<128>(n, reps);
+    run<256>(n, reps);
+    return 0;
+}
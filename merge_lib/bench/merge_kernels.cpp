@@ -0,0 +1,102 @@
+// Микробенчмарк ядер слияния: ветвящийся цикл (как merge() в merge_thread.cpp),
+// std::merge, слияние без ветвлений, SSE4.1 и AVX2.
+// g++ -O2 merge_kernels.cpp -o merge_kernels
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../kernels.hpp"
+
+void merge_branchy(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] <= b[j]) {
+            out[k] = a[i];
+            i++;
+        } else {
+            out[k] = b[j];
+            j++;
+        }
+        k++;
+    }
+    while (i < na) out[k++] = a[i++];
+    while (j < nb) out[k++] = b[j++];
+}
+
+using Kernel = std::function<void(const int*, std::size_t, const int*, std::size_t, int*)>;
+
+// Лучшее время на элемент (нс) из reps повторов
+double measure(const Kernel& kernel, const std::vector<int>& a, const std::vector<int>& b, int reps) {
+    std::vector<int> out(a.size() + b.size());
+    double best = 1e9;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        kernel(a.data(), a.size(), b.data(), b.size(), out.data());
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    return best / out.size();
+}
+
+int main(int argc, char** argv) {
+    const std::size_t N = argc > 1 ? std::atol(argv[1]) : 1'000'000;  // длина каждого входа
+
+    struct Input { std::string name; int modulo; bool disjoint; };
+    std::vector<Input> inputs = {
+        {"random", (int)(2 * N), false},
+        {"sorted", (int)(2 * N), true},    // a целиком меньше b
+        {"few-unique", 10, false},
+    };
+
+    namespace simd = merge_lib::simd;
+    simd::isa best_isa = simd::active_isa();
+
+    std::vector<std::pair<std::string, Kernel>> kernels = {
+        {"branchy", merge_branchy},
+        {"std::merge", [](const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+            std::merge(a, a + na, b, b + nb, out);
+        }},
+        {"branchless", [](const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+            merge_lib::merge_branchless(a, a + na, b, b + nb, out, std::less<int>());
+        }},
+    };
+    if (best_isa >= simd::isa::sse41)
+        kernels.push_back({"sse4.1", [](const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+            simd::active_isa() = simd::isa::sse41;
+            simd::merge(a, na, b, nb, out);
+        }});
+    if (best_isa >= simd::isa::avx2)
+        kernels.push_back({"avx2", [](const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+            simd::active_isa() = simd::isa::avx2;
+            simd::merge(a, na, b, nb, out);
+        }});
+
+    std::cout << "Длина входов: " << N << " + " << N << ", нс/элемент\n\n";
+    std::cout << std::left << std::setw(12) << "kernel";
+    for (auto& in : inputs) std::cout << std::setw(12) << in.name;
+    std::cout << "\n";
+
+    for (auto& [name, kernel] : kernels) {
+        std::cout << std::setw(12) << name;
+        for (auto& in : inputs) {
+            std::vector<int> a(N), b(N);
+            for (std::size_t i = 0; i < N; i++) {
+                a[i] = rand() % in.modulo;
+                b[i] = rand() % in.modulo + (in.disjoint ? in.modulo : 0);
+            }
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            std::cout << std::setw(12) << std::setprecision(3) << measure(kernel, a, b, 10);
+        }
+        std::cout << "\n";
+    }
+
+    simd::active_isa() = best_isa;
+    return 0;
+}
@@ -0,0 +1,206 @@
+// Микробенчмарки отдельных ядер: слияние, copy-back, сортировка листа, редукции
+// из not_paral.cpp / paral.cpp и обмен send_vector / recv_vector.
+// Размеры перебираются по уровням кэша (половина L1, L2, L3 и 4 x L3).
+//
+//   g++ -O2 -mavx2 -fopenmp micro.cpp -o micro
+//   ./micro [--filter merge] [--min-time 0.2] [--format table|csv|json] [--out файл]
+//
+//   mpicxx -O2 -mavx2 -fopenmp -DBENCH_MPI micro.cpp -o micro_mpi
+//   mpirun -np 2 ./micro_mpi --filter mpi/
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "microbench.hpp"
+#include "../kernels.hpp"
+
+#ifdef BENCH_MPI
+#include "../mpi_transport.hpp"
+#endif
+
+std::vector<int> random_ints(std::size_t n, std::uint64_t seed = 42) {
+    std::mt19937 gen(seed);
+    std::vector<int> a(n);
+    for (auto& x : a) x = (int)gen();
+    return a;
+}
+
+// ---- Слияние: два отсортированных входа по arg элементов ----
+
+template <class Merge>
+void bm_merge(bench::state& st, Merge merge) {
+    std::size_t n = st.arg;
+    std::vector<int> a = random_ints(n, 1), b = random_ints(n, 2), out(2 * n);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+
+    while (st.keep_running()) {
+        merge(a.data(), a.data() + n, b.data(), b.data() + n, out.data());
+        bench::do_not_optimize(out[n]);
+    }
+    st.items(2 * n);
+    st.bytes(2 * 2 * n * sizeof(int));   // чтение входов + запись выхода
+    st.working_set(4 * n * sizeof(int));
+}
+
+// ---- Copy-back: tmp -> a после слияния (режим ping_pong = false) ----
+
+void bm_copy(bench::state& st) {
+    std::vector<int> src(st.arg, 1), dst(st.arg);
+    while (st.keep_running()) {
+        std::copy(src.begin(), src.end(), dst.begin());
+        bench::do_not_optimize(dst[0]);
+    }
+    st.items(st.arg);
+    st.bytes(2 * st.arg * sizeof(int));
+    st.working_set(2 * st.arg * sizeof(int));
+}
+
+// ---- Лист: sort_sequential на блоках по arg элементов ----
+
+// Блоки покрывают половину L2, чтобы мелкие листья не мерились в одном L1
+void bm_leaf(bench::state& st, merge_lib::leaf_kind kind) {
+    std::size_t n = st.arg;
+    std::size_t total = std::max(n, bench::caches().l2 / 2 / (2 * sizeof(int))) / n * n;
+    std::vector<int> src = random_ints(total), a(total), tmp(total);
+
+    merge_lib::Params p;
+    p.leaf_algo = kind;
+
+    while (st.keep_running()) {
+        st.pause();
+        std::copy(src.begin(), src.end(), a.begin());
+        st.resume();
+        for (std::size_t l = 0; l < total; l += n)
+            merge_lib::sort_sequential(a.data() + l, tmp.data() + l, n, p, std::less<int>());
+        bench::do_not_optimize(a[0]);
+    }
+    st.items(total);
+    st.bytes(total * sizeof(int));
+    st.working_set(2 * total * sizeof(int));
+}
+
+// ---- Редукции: те же функции, что в not_paral.cpp и paral.cpp ----
+
+int64_t sum(const std::vector<int>& a) {
+    int64_t s = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        s += a[i];
+    }
+    return s;
+}
+
+int64_t sum_parallel(const std::vector<int>& a) {
+    int64_t s = 0;
+
+#pragma omp parallel for reduction(+:s)
+    for (size_t i = 0; i < a.size(); i++) {
+        s += a[i];
+    }
+    return s;
+}
+
+template <class Sum>
+void bm_sum(bench::state& st, Sum fn) {
+    std::vector<int> a(st.arg, 1);
+    while (st.keep_running()) bench::do_not_optimize(fn(a));
+    st.items(st.arg);
+    st.bytes(st.arg * sizeof(int));
+    st.working_set(st.arg * sizeof(int));
+}
+
+// ---- Обмен: rank 0 -> rank 1 -> rank 0, arg байт в каждую сторону ----
+
+#ifdef BENCH_MPI
+void bm_roundtrip(bench::state& st) {
+    int rank = bench::rank();
+    std::vector<char> data(st.arg, 1);
+
+    while (st.keep_running()) {
+        if (rank == 0) {
+            merge_lib::send_vector(1, merge_lib::TAG_LARGE_TRANSFER, data);
+            data = merge_lib::recv_vector<char>(1, merge_lib::TAG_LARGE_TRANSFER);
+        } else if (rank == 1) {
+            auto echo = merge_lib::recv_vector<char>(0, merge_lib::TAG_LARGE_TRANSFER);
+            merge_lib::send_vector(0, merge_lib::TAG_LARGE_TRANSFER, echo);
+        }
+    }
+    st.items(1);
+    st.bytes(2 * st.arg);
+}
+#endif
+
+int main(int argc, char** argv) {
+#ifdef BENCH_MPI
+    MPI_Init(&argc, &argv);
+    std::string default_filter = "mpi/";
+#else
+    std::string default_filter = "";
+#endif
+
+    auto args = bench::parse_args(argc, argv);
+    std::string filter = args.count("filter") ? args["filter"] : default_filter;
+    double min_time = args.count("min-time") ? std::stod(args["min-time"]) : 0.2;
+    std::string format = args.count("format") ? args["format"] : "table";
+
+    using merge_lib::leaf_kind;
+    auto merge_sizes = bench::cache_sweep(4 * sizeof(int));
+    auto sum_sizes = bench::cache_sweep(sizeof(int));
+
+    bench::add("merge/std::merge", [](bench::state& st) {
+        bm_merge(st, [](const int* a, const int* ae, const int* b, const int* be, int* out) {
+            std::merge(a, ae, b, be, out);
+        });
+    }, merge_sizes);
+    bench::add("merge/branchless", [](bench::state& st) {
+        bm_merge(st, [](const int* a, const int* ae, const int* b, const int* be, int* out) {
+            merge_lib::merge_branchless(a, ae, b, be, out, std::less<int>());
+        });
+    }, merge_sizes);
+    bench::add("merge/merge_runs", [](bench::state& st) {
+        bm_merge(st, [](const int* a, const int* ae, const int* b, const int* be, int* out) {
+            merge_lib::merge_runs(a, ae, b, be, out, std::less<int>());
+        });
+    }, merge_sizes);
+
+    bench::add("copy/copy_back", bm_copy, bench::cache_sweep(2 * sizeof(int)));
+
+    bench::add("leaf/insertion", [](bench::state& st) { bm_leaf(st, leaf_kind::insertion); },
+               {16, 32, 64, 256, 1024, 16384});
+    bench::add("leaf/simd", [](bench::state& st) { bm_leaf(st, leaf_kind::simd); },
+               {16, 32, 64, 256, 1024, 16384});
+
+    bench::add("reduce/sum", [](bench::state& st) { bm_sum(st, sum); }, sum_sizes);
+    bench::add("reduce/sum_parallel", [](bench::state& st) { bm_sum(st, sum_parallel); }, sum_sizes);
+
+#ifdef BENCH_MPI
+    int ranks;
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+    if (ranks >= 2)
+        bench::add("mpi/roundtrip", bm_roundtrip, {8, 1 << 10, 64 << 10, 1 << 20, 16 << 20});
+#endif
+
+    auto rows = bench::run(filter, min_time);
+
+    if (bench::rank() == 0) {
+        bench::cache_sizes c = bench::caches();
+        std::cerr << "L1 " << c.l1 / 1024 << " KiB, L2 " << c.l2 / 1024 << " KiB, L3 "
+                  << c.l3 / 1024 << " KiB, потоков OpenMP " << omp_get_max_threads() << "\n";
+        if (args.count("out")) {
+            std::ofstream out(args["out"]);
+            bench::write(out, rows, format);
+        } else {
+            bench::write(std::cout, rows, format);
+        }
+    }
+
+#ifdef BENCH_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
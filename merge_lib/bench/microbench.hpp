@@ -0,0 +1,179 @@
+#pragma once
+
+// Минимальный каркас микробенчмарков в духе Google Benchmark, без зависимостей.
+//
+//   void bm_sum(bench::state& st) {
+//       std::vector<int> a(st.arg, 1);
+//       while (st.keep_running()) bench::do_not_optimize(sum(a));
+//       st.items(st.arg);
+//       st.bytes(st.arg * sizeof(int));
+//   }
+//   bench::add("sum", bm_sum, bench::cache_sweep(sizeof(int)));
+//
+// Число итераций подбирается, пока замер не займёт --min-time секунд.
+// Результат: нс на итерацию, элементы/с, GB/s и уровень кэша, в который
+// помещается рабочий набор (st.working_set).
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+
+#ifdef BENCH_MPI
+#include <mpi.h>
+#endif
+
+namespace bench {
+
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class state {
+public:
+    std::size_t arg;
+
+    state(std::size_t arg, std::size_t iterations) : arg(arg), left_(iterations) {}
+
+    // Первый вызов запускает таймер, последний — останавливает
+    bool keep_running() {
+        if (!started_) {
+            started_ = true;
+            start_ = now();
+        }
+        if (left_ == 0) {
+            elapsed_ += now() - start_;
+            return false;
+        }
+        left_--;
+        return true;
+    }
+
+    // Подготовка данных внутри итерации, не входит в замер
+    void pause() { elapsed_ += now() - start_; }
+    void resume() { start_ = now(); }
+
+    // Обработано за одну итерацию
+    void items(std::size_t n) { items_ = n; }
+    void bytes(std::size_t n) { bytes_ = n; }
+    void working_set(std::size_t n) { working_set_ = n; }
+
+    double elapsed() const { return elapsed_; }
+    std::size_t items() const { return items_; }
+    std::size_t bytes() const { return bytes_; }
+    std::size_t working_set() const { return working_set_; }
+
+private:
+    std::size_t left_;
+    bool started_ = false;
+    double start_ = 0, elapsed_ = 0;
+    std::size_t items_ = 0, bytes_ = 0, working_set_ = 0;
+};
+
+struct micro_case {
+    std::string name;
+    std::function<void(state&)> fn;
+    std::vector<std::size_t> args;
+};
+
+inline std::vector<micro_case>& registry() {
+    static std::vector<micro_case> cases;
+    return cases;
+}
+
+inline void add(const std::string& name, std::function<void(state&)> fn, std::vector<std::size_t> args) {
+    registry().push_back({name, std::move(fn), std::move(args)});
+}
+
+// ---- Кэши ----
+
+struct cache_sizes {
+    std::size_t l1, l2, l3;
+};
+
+// Размеры кэшей данных из sysconf; в контейнерах бывают нули — тогда типичные
+inline cache_sizes caches() {
+    auto get = [](int name, std::size_t fallback) {
+        long v = sysconf(name);
+        return v > 0 ? (std::size_t)v : fallback;
+    };
+    return {get(_SC_LEVEL1_DCACHE_SIZE, 32 << 10),
+            get(_SC_LEVEL2_CACHE_SIZE, 1 << 20),
+            get(_SC_LEVEL3_CACHE_SIZE, 32 << 20)};
+}
+
+inline std::string cache_level(std::size_t bytes) {
+    cache_sizes c = caches();
+    if (bytes <= c.l1) return "L1";
+    if (bytes <= c.l2) return "L2";
+    if (bytes <= c.l3) return "L3";
+    return "RAM";
+}
+
+// Число элементов, при котором рабочий набор (per_elem байт на элемент)
+// занимает половину L1, L2, L3 и четыре L3 (но не больше 1 ГиБ)
+inline std::vector<std::size_t> cache_sweep(std::size_t per_elem) {
+    cache_sizes c = caches();
+    std::size_t ram = std::min<std::size_t>(4 * c.l3, std::size_t(1) << 30);
+    return {c.l1 / 2 / per_elem, c.l2 / 2 / per_elem, c.l3 / 2 / per_elem, ram / per_elem};
+}
+
+// ---- Запуск ----
+
+inline int rank() {
+#ifdef BENCH_MPI
+    int r;
+    MPI_Comm_rank(MPI_COMM_WORLD, &r);
+    return r;
+#else
+    return 0;
+#endif
+}
+
+// Все случаи с подстрокой filter в имени. С MPI итерации выбирает rank 0,
+// остальные ранги повторяют его решения (для обменов нужны обе стороны)
+inline std::vector<record> run(const std::string& filter, double min_time) {
+    std::vector<record> rows;
+    for (auto& c : registry()) {
+        if (c.name.find(filter) == std::string::npos) continue;
+        for (std::size_t arg : c.args) {
+            std::size_t iterations = 1;
+            for (;;) {
+                state st(arg, iterations);
+                c.fn(st);
+
+                double elapsed = st.elapsed();
+#ifdef BENCH_MPI
+                MPI_Bcast(&elapsed, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+                if (elapsed < min_time && iterations < (std::size_t(1) << 40)) {
+                    // До min_time с запасом, но не больше чем в 10 раз за шаг
+                    double grow = elapsed > 0 ? 1.4 * min_time / elapsed : 10;
+                    iterations = (std::size_t)(iterations * std::min(10.0, std::max(2.0, grow)));
+                    continue;
+                }
+
+                double per_iter = elapsed / iterations;
+                record row;
+                row.add("name", c.name)
+                   .add("arg", arg)
+                   .add("iterations", iterations)
+                   .add("ns_per_iter", per_iter * 1e9)
+                   .add("melem_s", st.items() ? st.items() / per_iter / 1e6 : 0)
+                   .add("gb_s", st.bytes() ? st.bytes() / per_iter / 1e9 : 0)
+                   .add("working_set_kib", st.working_set() / 1024)
+                   .add("fits", st.working_set() ? cache_level(st.working_set()) : "-");
+                rows.push_back(row);
+                break;
+            }
+        }
+    }
+    return rows;
+}
+
+} // namespace bench
@@ -0,0 +1,75 @@
+// Адаптивный режим leaf_kind::natural против обычных листьев на входах
+// с разной степенью упорядоченности.
+// g++ -O2 -mavx2 -fopenmp natural_sort.cpp -o natural_sort
+
+#include <omp.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../merge_sort.hpp"
+#include "../backend_omp.hpp"
+
+double measure(const std::vector<int>& data, merge_lib::omp_backend& be,
+               const merge_lib::Params& p, int reps) {
+    double best = 1e30;
+    for (int i = 0; i < reps; i++) {
+        std::vector<int> a = data;
+        double start = omp_get_wtime();
+        merge_lib::sort(a, be, p);
+        best = std::min(best, omp_get_wtime() - start);
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    if (n == 0) {
+        std::cerr << "n должно быть больше 0\n";
+        return 1;
+    }
+    int reps = 3;
+
+    std::mt19937 gen(7);
+    std::vector<int> random(n);
+    for (auto& x : random) x = gen();
+
+    std::vector<int> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> reverse(sorted.rbegin(), sorted.rend());
+
+    std::vector<int> nearly = sorted;
+    for (int k = 0; k < 1000; k++) std::swap(nearly[gen() % n], nearly[gen() % n]);
+
+    // 16 отсортированных пачек, как после конкатенации результатов
+    std::vector<int> batches = random;
+    std::size_t batch = std::max<std::size_t>(1, n / 16);
+    for (std::size_t i = 0; i < n; i += batch)
+        std::sort(batches.begin() + i, batches.begin() + std::min(n, i + batch));
+
+    // Отсортированный массив с дописанным в конец случайным хвостом 1%
+    std::vector<int> appended = sorted;
+    std::copy(random.begin(), random.begin() + n / 100, appended.end() - n / 100);
+    std::sort(appended.begin(), appended.end() - n / 100);
+
+    merge_lib::omp_backend be;
+    merge_lib::Params insertion, simd, natural;
+    insertion.leaf_algo = merge_lib::leaf_kind::insertion;
+    natural.leaf_algo = merge_lib::leaf_kind::natural;
+
+    std::cout << "| Вход | insertion | simd | natural |\n"
+              << "| :--- | :-------: | :--: | :-----: |\n";
+    auto row = [&](const std::string& name, const std::vector<int>& data) {
+        std::cout << "| " << name << " | " << measure(data, be, insertion, reps) << " | "
+                  << measure(data, be, simd, reps) << " | " << measure(data, be, natural, reps) << " |\n";
+    };
+    row("случайный", random);
+    row("отсортированный", sorted);
+    row("обратный", reverse);
+    row("почти (1000 обменов)", nearly);
+    row("16 пачек", batches);
+    row("+1% хвост", appended);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Сравнение merge + copy-back и ping-pong: перемещения элементов и время.
+// g++ -O2 -fopenmp ping_pong.cpp -o ping_pong
+
+#include <omp.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../merge_sort.hpp"
+#include "../backend_omp.hpp"
+
+// Элемент, считающий свои копирования и перемещения
+struct Counted {
+    int v = 0;
+    static inline std::uint64_t moves = 0;
+
+    Counted() = default;
+    Counted(int x) : v(x) {}
+    Counted(const Counted& o) : v(o.v) { moves++; }
+    Counted& operator=(const Counted& o) { v = o.v; moves++; return *this; }
+    bool operator<(const Counted& o) const { return v < o.v; }
+};
+
+std::uint64_t count_moves(const std::vector<int>& data, bool ping_pong) {
+    std::vector<Counted> a(data.begin(), data.end());
+    merge_lib::serial_backend be;
+    merge_lib::Params params;
+    params.ping_pong = ping_pong;
+
+    Counted::moves = 0;
+    merge_lib::sort(a, be, params);
+    return Counted::moves;
+}
+
+double time_sort(const std::vector<int>& data, bool ping_pong, int reps) {
+    merge_lib::omp_backend be;
+    merge_lib::Params params;
+    params.ping_pong = ping_pong;
+
+    double best = 1e9;
+    for (int r = 0; r < reps; r++) {
+        std::vector<int> a = data;
+        std::vector<int> tmp(a.size());
+        double t0 = omp_get_wtime();
+        merge_lib::sort(a.data(), a.data() + a.size(), tmp.data(), be, params);
+        double t1 = omp_get_wtime();
+        best = std::min(best, t1 - t0);
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    const int N = argc > 1 ? std::atoi(argv[1]) : 2'000'000;
+
+    std::vector<int> data(N);
+    for (int i = 0; i < N; i++)
+        data[i] = rand() % N;
+
+    std::uint64_t moves_copy = count_moves(data, false);
+    std::uint64_t moves_pp = count_moves(data, true);
+    double t_copy = time_sort(data, false, 5);
+    double t_pp = time_sort(data, true, 5);
+
+    double mb = 1.0 / (1024 * 1024);
+    std::cout << "Размер массива: " << N << "\n";
+    std::cout << "Потоков:        " << omp_get_max_threads() << "\n\n";
+    std::cout << "copy-back: " << moves_copy * sizeof(int) * mb << " MiB записано, "
+              << t_copy << " сек\n";
+    std::cout << "ping-pong: " << moves_pp * sizeof(int) * mb << " MiB записано, "
+              << t_pp << " сек\n";
+    std::cout << "Сокращение записи: " << (double)moves_copy / moves_pp << "x\n";
+
+    return 0;
+}
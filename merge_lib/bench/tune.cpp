@@ -0,0 +1,124 @@
+// Подбор cutoff, глубины дерева и сортировки листа для этой машины (tuning.hpp).
+// Результат дописывается в файл профиля, программы читают его через tuned_params.
+//
+//   g++ -O2 -mavx2 -fopenmp -pthread tune.cpp -o tune
+//   g++ -O2 -mavx2 -fopenmp -pthread -DBENCH_TBB tune.cpp -o tune -ltbb
+//
+//   ./tune --engines omp,thread --threads 1,2,4 --keys 32,64 --n 2e6 --reps 3 --out merge_lib.profile
+//
+// Без --out — MERGE_LIB_PROFILE или ./merge_lib.profile. --verbose печатает каждый замер.
+
+#include <omp.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "../tuning.hpp"
+#include "../backend_omp.hpp"
+#include "../backend_thread.hpp"
+
+#ifdef BENCH_TBB
+#include "../backend_tbb.hpp"
+#endif
+
+template <class T, class Backend>
+void tune_one(Backend& be, const std::string& engine, int threads, std::size_t n, int reps, bool verbose,
+              const std::string& path, std::vector<bench::record>& rows)
+{
+    std::cerr << engine << " " << merge_lib::type_name<T>() << " x" << threads << "\n";
+    auto r = merge_lib::tune<T>(be, n, reps, verbose ? &std::cerr : nullptr);
+
+    merge_lib::profile_entry e;
+    e.cpu = merge_lib::cpu_model();
+    e.backend = engine;
+    e.type = merge_lib::type_name<T>();
+    e.threads = threads;
+    e.cutoff = r.params.cutoff;
+    e.max_depth = r.params.max_depth;
+    e.leaf_algo = r.params.leaf_algo;
+    e.seconds = r.seconds;
+    e.n = n;
+    if (!merge_lib::save_profile(e, path)) std::cerr << "не удалось записать " << path << "\n";
+
+    bench::record row;
+    row.add("engine", engine)
+       .add("type", e.type)
+       .add("threads", threads)
+       .add("cutoff", e.cutoff)
+       .add("max_depth", e.max_depth)
+       .add("leaf_algo", merge_lib::to_string(e.leaf_algo))
+       .add("best_s", r.seconds)
+       .add("configs", r.measured);
+    rows.push_back(row);
+}
+
+template <class T>
+void tune_engine(const std::string& engine, int threads, std::size_t n, int reps, bool verbose,
+                 const std::string& path, std::vector<bench::record>& rows)
+{
+    using namespace merge_lib;
+    if (engine == "omp") {
+        omp_backend be;
+        be.threads = threads;
+        tune_one<T>(be, engine, threads, n, reps, verbose, path, rows);
+    } else if (engine == "thread") {
+        work_stealing_pool pool(threads);
+        thread_backend be;
+        be.pool = &pool;
+        tune_one<T>(be, engine, threads, n, reps, verbose, path, rows);
+    } else if (engine == "pool") {
+        thread_pool pool(threads - 1);
+        pool_backend be;
+        be.pool = &pool;
+        tune_one<T>(be, engine, threads, n, reps, verbose, path, rows);
+#ifdef BENCH_TBB
+    } else if (engine == "tbb") {
+        tbb_backend be;
+        be.threads = threads;
+        tune_one<T>(be, engine, threads, n, reps, verbose, path, rows);
+#endif
+    } else {
+        std::cerr << "неизвестный движок: " << engine << "\n";
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto args = bench::parse_args(argc, argv);
+    auto get = [&](const std::string& key, const std::string& def) {
+        return args.count(key) ? args[key] : def;
+    };
+
+    std::vector<std::string> engines = bench::split(get("engines", "omp"));
+    std::vector<int> thread_counts;
+    for (auto& s : bench::split(get("threads", std::to_string(omp_get_max_threads()))))
+        thread_counts.push_back(std::stoi(s));
+    std::size_t n = bench::parse_size(get("n", "2e6"));
+    int reps = std::stoi(get("reps", "3"));
+    bool verbose = args.count("verbose");
+    std::string path = get("out", merge_lib::profile_path());
+
+    std::cerr << "процессор: " << merge_lib::cpu_model() << ", профиль: " << path << "\n";
+
+    std::vector<std::string> key_sizes = bench::split(get("keys", "32"));
+    for (auto& keys : key_sizes)
+        if (keys != "32" && keys != "64") {
+            std::cerr << "неизвестный размер ключа: " << keys << " (есть: 32,64)\n";
+            std::exit(1);
+        }
+
+    std::vector<bench::record> rows;
+    for (auto& keys : key_sizes)
+        for (auto& engine : engines)
+            for (int threads : thread_counts) {
+                if (keys == "64")
+                    tune_engine<std::int64_t>(engine, threads, n, reps, verbose, path, rows);
+                else
+                    tune_engine<std::int32_t>(engine, threads, n, reps, verbose, path, rows);
+            }
+
+    bench::write(std::cout, rows, get("format", "table"));
+    return 0;
+}
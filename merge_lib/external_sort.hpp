@@ -0,0 +1,284 @@
+#pragma once
+
+// Внешняя сортировка двоичных файлов, которые не помещаются в память.
+//
+//   merge_lib::omp_backend be;
+//   merge_lib::ExternalParams ep;
+//   ep.memory_budget = 4ull << 30;
+//   merge_lib::external_sort<std::int64_t>("in.bin", "out.bin", be, ep);
+//
+// 1. Генерация серий: файл читается кусками по memory_budget / 2, каждый кусок
+//    сортируется параллельным движком в памяти и пишется во временный файл.
+// 2. K-way слияние серий потоком (дерево проигравших, multiway_merge.hpp):
+//    у каждой серии свой буфер с упреждающим чтением, выход пишется большими
+//    блоками. Чтение и запись выполняет небольшой общий пул потоков ввода-вывода.
+//    Если серий слишком много для бюджета, слияние идёт в несколько проходов.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "multiway_merge.hpp"
+#include "thread_pool.hpp"
+
+namespace merge_lib {
+
+struct ExternalParams {
+    std::size_t memory_budget = std::size_t(1) << 30;  // байт на данные и буферы
+    std::size_t min_block = std::size_t(1) << 20;      // минимальный блок ввода-вывода, байт
+    std::string tmp_dir = ".";
+    Params params;                                     // параметры сортировки в памяти
+};
+
+namespace external_detail {
+
+// Потоки ввода-вывода на всю сортировку: блоки читаются и пишутся по очереди
+// (FIFO), без отдельного потока на каждый блок или серию
+constexpr int kIoThreads = 2;
+
+inline std::FILE* open_file(const std::string& path, const char* mode) {
+    std::FILE* f = std::fopen(path.c_str(), mode);
+    if (!f) throw std::runtime_error("external_sort: не удалось открыть " + path);
+    return f;
+}
+
+template <class T>
+std::size_t read_block(std::FILE* f, T* buf, std::size_t count) {
+    std::size_t got = std::fread(buf, sizeof(T), count, f);
+    if (got < count && std::ferror(f)) throw std::runtime_error("external_sort: ошибка чтения");
+    return got;
+}
+
+template <class T>
+void write_block(std::FILE* f, const T* buf, std::size_t count) {
+    if (count == 0) return;   // буфер писателя с block = 0 — nullptr
+    if (std::fwrite(buf, sizeof(T), count, f) != count)
+        throw std::runtime_error("external_sort: ошибка записи");
+}
+
+// fn в пуле ввода-вывода; исключение fn передаётся через future
+template <class F>
+auto io_async(thread_pool& io, F fn) -> std::future<decltype(fn())> {
+    auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+    auto result = task->get_future();
+    io.submit([task] { (*task)(); });
+    return result;
+}
+
+// Последовательное чтение серии с упреждением: пока слияние разбирает
+// текущий блок, следующий уже читается в пуле io
+template <class T>
+class run_reader {
+public:
+    run_reader(const std::string& path, std::size_t block, thread_pool& io)
+        : io_(io), f_(open_file(path, "rb")), cur_(block), next_(block) {
+        std::setvbuf(f_, nullptr, _IONBF, 0);
+        prefetch();
+        refill();
+    }
+
+    ~run_reader() {
+        if (pending_.valid()) pending_.wait();
+        std::fclose(f_);
+    }
+
+    bool empty() const { return pos_ == len_; }
+    const T& front() const { return cur_[pos_]; }
+
+    void pop() {
+        if (++pos_ == len_) refill();
+    }
+
+private:
+    void prefetch() {
+        pending_ = io_async(io_, [this] { return read_block(f_, next_.data(), next_.size()); });
+    }
+
+    void refill() {
+        len_ = pending_.get();
+        pos_ = 0;
+        cur_.swap(next_);
+        if (len_ > 0) prefetch();
+    }
+
+    thread_pool& io_;
+    std::FILE* f_;
+    std::vector<T> cur_, next_;
+    std::future<std::size_t> pending_;
+    std::size_t pos_ = 0, len_ = 0;
+};
+
+// Буферизованная запись: заполненный блок пишется в пуле io, пока копится следующий.
+// Результат проверяет close(); без него деструктор дописывает хвост, не бросая исключений
+template <class T>
+class run_writer {
+public:
+    run_writer(const std::string& path, std::size_t block, thread_pool& io)
+        : io_(io), f_(open_file(path, "wb")), cur_(block), next_(block) {
+        std::setvbuf(f_, nullptr, _IONBF, 0);
+    }
+
+    ~run_writer() {
+        if (pending_.valid()) pending_.wait();
+        if (len_ > 0) std::fwrite(cur_.data(), sizeof(T), len_, f_);
+        std::fclose(f_);
+    }
+
+    void push(const T& x) {
+        cur_[len_++] = x;
+        if (len_ == cur_.size()) flush_async();
+    }
+
+    void write(const T* data, std::size_t n) {
+        if (pending_.valid()) pending_.get();
+        write_block(f_, cur_.data(), len_);
+        len_ = 0;
+        write_block(f_, data, n);
+    }
+
+    void close() {
+        if (pending_.valid()) pending_.get();
+        write_block(f_, cur_.data(), len_);
+        len_ = 0;
+        std::fflush(f_);
+    }
+
+private:
+    void flush_async() {
+        if (pending_.valid()) pending_.get();
+        cur_.swap(next_);
+        std::size_t n = len_;
+        len_ = 0;
+        pending_ = io_async(io_, [this, n] { write_block(f_, next_.data(), n); });
+    }
+
+    thread_pool& io_;
+    std::FILE* f_;
+    std::vector<T> cur_, next_;
+    std::future<void> pending_;
+    std::size_t len_ = 0;
+};
+
+// Источник для loser_tree поверх run_reader (сами читатели не перемещаемы)
+template <class T>
+struct reader_source {
+    run_reader<T>* r;
+
+    bool empty() const { return r->empty(); }
+    const T& front() const { return r->front(); }
+    void pop() { r->pop(); }
+};
+
+// Слияние серий paths в файл out одним потоком через дерево проигравших
+template <class T, class Compare>
+void merge_files(const std::vector<std::string>& paths, const std::string& out,
+                 std::size_t block, thread_pool& io, Compare comp)
+{
+    std::vector<std::unique_ptr<run_reader<T>>> readers;
+    std::vector<reader_source<T>> src;
+    for (auto& path : paths) {
+        readers.emplace_back(new run_reader<T>(path, block, io));
+        src.push_back({readers.back().get()});
+    }
+
+    loser_tree<reader_source<T>, Compare> tree(src, comp);
+    run_writer<T> writer(out, block, io);
+    while (!tree.empty()) {
+        writer.push(tree.front());
+        tree.pop();
+    }
+    writer.close();
+}
+
+inline std::string run_path(const ExternalParams& ep, const std::string& out, int pass, std::size_t i) {
+    std::string base = out.substr(out.find_last_of("/\\") + 1);
+    return ep.tmp_dir + "/" + base + ".run" + std::to_string(pass) + "_" + std::to_string(i);
+}
+
+} // namespace external_detail
+
+// Сортирует двоичный файл элементов T (int32/int64 и т.п.) в output
+template <class T, class Backend, class Compare = std::less<T>>
+void external_sort(const std::string& input, const std::string& output, Backend& be,
+                   const ExternalParams& ep = {}, Compare comp = {})
+{
+    using namespace external_detail;
+    thread_pool io(kIoThreads);   // переживает всех читателей и писателей ниже
+
+    // Этап 1: генерация отсортированных серий (данные + tmp в бюджете)
+    std::size_t run_len = std::max<std::size_t>(1, ep.memory_budget / (2 * sizeof(T)));
+    std::vector<std::string> runs;
+    {
+        std::vector<T> data(run_len), tmp(run_len);
+        std::FILE* in = open_file(input, "rb");
+        while (true) {
+            std::size_t n = read_block(in, data.data(), run_len);
+            if (n == 0) break;
+
+            sort(data.data(), data.data() + n, tmp.data(), be, ep.params, comp);
+
+            runs.push_back(run_path(ep, output, 0, runs.size()));
+            run_writer<T> writer(runs.back(), 0, io);
+            writer.write(data.data(), n);
+            writer.close();
+
+            if (n < run_len) break;
+        }
+        std::fclose(in);
+    }
+
+    if (runs.empty()) {
+        run_writer<T> empty(output, 0, io);
+        empty.close();
+        return;
+    }
+
+    // Этап 2: k-way слияние. Каждому входу и выходу нужны два блока (упреждение),
+    // блок не меньше min_block — отсюда предельная степень слияния за проход.
+    // Слиянию двух серий нужно три пары блоков: при малом бюджете блок уменьшается
+    std::size_t min_block = std::max<std::size_t>(1, ep.min_block / sizeof(T));
+    min_block = std::max<std::size_t>(1, std::min(min_block, ep.memory_budget / (2 * sizeof(T) * 3)));
+    std::size_t q = ep.memory_budget / (2 * sizeof(T) * min_block);
+    std::size_t max_fan_in = q > 2 ? q - 1 : 2;
+
+    for (int pass = 1; runs.size() > 1; pass++) {
+        std::size_t fan_in = std::min(runs.size(), max_fan_in);
+        std::size_t block = std::max(min_block, ep.memory_budget / (2 * sizeof(T) * (fan_in + 1)));
+
+        std::vector<std::string> next;
+        for (std::size_t i = 0; i < runs.size(); i += fan_in) {
+            std::vector<std::string> group(runs.begin() + i,
+                                           runs.begin() + std::min(runs.size(), i + fan_in));
+            // Хвост из одной серии переходит в следующий проход без копирования;
+            // её имя с номером прошлого прохода новым сериям не достанется
+            if (group.size() == 1) {
+                next.push_back(group[0]);
+                continue;
+            }
+            bool last = (fan_in == runs.size());
+            std::string out = last ? output : run_path(ep, output, pass, next.size());
+            merge_files<T>(group, out, block, io, comp);
+            for (auto& path : group) std::remove(path.c_str());
+            next.push_back(out);
+        }
+        runs.swap(next);
+    }
+
+    // Одна серия с самого начала — просто переименовываем
+    if (runs[0] != output) {
+        std::remove(output.c_str());
+        if (std::rename(runs[0].c_str(), output.c_str()) != 0) {
+            merge_files<T>(runs, output, min_block, io, comp);
+            std::remove(runs[0].c_str());
+        }
+    }
+}
+
+} // namespace merge_lib
@@ -0,0 +1,173 @@
+#pragma once
+
+// Быстрый путь для входа с малым числом различных ключей.
+//
+// По равномерной выборке из kSample элементов строится таблица различных
+// ключей; если их не больше kMaxKeys, один параллельный проход считает
+// гистограммы по блокам (у целых с узким диапазоном корзина — x - min, иначе
+// ключ ищется двоичным поиском в таблице). Встретился
+// ключ не из таблицы — выборка ошиблась, возвращаемся к слиянию. Иначе —
+// устойчивая сортировка подсчётом: для целых с обычным порядком выход просто
+// заполняется ключами, для остальных типов элементы раскладываются по
+// корзинам через tmp (как проход radix_sort), порядок равных сохраняется.
+//
+// Для rand() % 10 на 2'000'000 это два прохода по данным вместо log2(n) уровней.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_for.hpp"
+
+namespace merge_lib {
+
+// Каким путём прошла сортировка
+enum class sort_path {
+    merge,     // дерево слияний
+    counting   // мало различных ключей: сортировка подсчётом
+};
+
+inline const char* to_string(sort_path path) {
+    return path == sort_path::counting ? "counting" : "merge";
+}
+
+namespace few_unique_detail {
+
+constexpr std::size_t kSample = 512;          // элементов в выборке
+constexpr std::size_t kMaxKeys = 64;          // больше различных — обычное слияние
+constexpr std::size_t kMaxRange = 1024;       // целые: ширина плотной гистограммы
+constexpr std::size_t kMinSize = 1 << 15;     // на меньших массивах не проверяем
+constexpr std::size_t kMinBlock = 1 << 16;    // минимальный блок на поток
+
+// Равные по comp ключи неотличимы: выход можно заполнить значениями таблицы
+template <class T, class Compare>
+constexpr bool fill_ok_v = std::is_integral<T>::value && !std::is_same<T, bool>::value
+    && (std::is_same<Compare, std::less<T>>::value || std::is_same<Compare, std::less<>>::value);
+
+// Различные ключи выборки по возрастанию; пусто, если их больше kMaxKeys
+template <class T, class Compare>
+std::vector<T> sample_keys(const T* a, std::size_t n, Compare comp) {
+    std::vector<T> keys;
+    keys.reserve(kSample);
+    for (std::size_t i = 0; i < kSample; i++)
+        keys.push_back(a[i * (n / kSample) + (n / kSample) / 2]);
+
+    std::sort(keys.begin(), keys.end(), comp);
+    auto same = [&](const T& x, const T& y) { return !comp(x, y) && !comp(y, x); };
+    keys.erase(std::unique(keys.begin(), keys.end(), same), keys.end());
+    if (keys.size() > kMaxKeys) keys.clear();
+    return keys;
+}
+
+// Номер ключа x в таблице или keys.size(), если его там нет
+template <class T, class Compare>
+std::size_t key_slot(const std::vector<T>& keys, const T& x, Compare comp) {
+    auto it = std::lower_bound(keys.begin(), keys.end(), x, comp);
+    if (it == keys.end() || comp(x, *it)) return keys.size();
+    return it - keys.begin();
+}
+
+// Устойчивая сортировка подсчётом по корзинам slot(x) < k; slot(x) >= k — отказ.
+// Fill: равные элементы неотличимы, выход заполняется значениями value(s),
+// иначе элементы раскладываются через tmp
+template <bool Fill, class Backend, class T, class Slot, class Value>
+bool counting_sort(T* a, T* tmp, std::size_t n, Backend& be, std::size_t k, Slot slot, Value value) {
+    if (k == 0) return false;
+    std::size_t blocks = std::max<std::size_t>(1, std::min<std::size_t>(be.concurrency(), n / kMinBlock));
+    std::size_t block_size = (n + blocks - 1) / blocks;
+    std::vector<std::size_t> hist(blocks * k);
+    std::atomic<bool> miss{false};
+
+    // 1. Гистограммы по блокам; ключ не из выборки — отказ
+    be.run([&] {
+        parallel_for(be, 0, blocks, [&](std::size_t b) {
+            std::size_t* h = &hist[b * k];
+            std::size_t l = b * block_size, r = std::min(n, l + block_size);
+            for (std::size_t i = l; i < r; i++) {
+                std::size_t s = slot(a[i]);
+                if (s >= k) {
+                    miss.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                if ((i & 4095) == 0 && miss.load(std::memory_order_relaxed)) return;
+                h[s]++;
+            }
+        });
+    });
+    if (miss.load()) return false;
+
+    // 2. Префиксные суммы: ключ старше блока
+    std::vector<std::size_t> key_begin(k + 1, n);
+    std::size_t offset = 0;
+    for (std::size_t s = 0; s < k; s++) {
+        key_begin[s] = offset;
+        for (std::size_t b = 0; b < blocks; b++) {
+            std::size_t c = hist[b * k + s];
+            hist[b * k + s] = offset;
+            offset += c;
+        }
+    }
+
+    be.run([&] {
+        if constexpr (Fill) {
+            // 3a. Блок выхода заполняется значениями ключей
+            parallel_for(be, 0, blocks, [&](std::size_t b) {
+                std::size_t l = b * block_size, r = std::min(n, l + block_size);
+                std::size_t s = std::upper_bound(key_begin.begin(), key_begin.end(), l) - key_begin.begin() - 1;
+                for (std::size_t i = l; i < r; s++) {
+                    std::size_t e = std::min(r, key_begin[s + 1]);
+                    std::fill(a + i, a + e, value(s));
+                    i = e;
+                }
+            });
+        } else {
+            // 3b. Устойчивая раскладка в tmp и копия обратно
+            parallel_for(be, 0, blocks, [&](std::size_t b) {
+                std::size_t* pos = &hist[b * k];
+                std::size_t l = b * block_size, r = std::min(n, l + block_size);
+                for (std::size_t i = l; i < r; i++)
+                    tmp[pos[slot(a[i])]++] = std::move(a[i]);
+            });
+            parallel_for(be, 0, blocks, [&](std::size_t b) {
+                std::size_t l = b * block_size, r = std::min(n, l + block_size);
+                std::move(tmp + l, tmp + r, a + l);
+            });
+        }
+    });
+    return true;
+}
+
+} // namespace few_unique_detail
+
+// Попытка отсортировать [a, a + n) подсчётом; false — ключей много, массив не тронут
+template <class Backend, class T, class Compare = std::less<T>>
+bool few_unique_sort(T* a, T* tmp, std::size_t n, Backend& be, Compare comp = {}) {
+    using namespace few_unique_detail;
+    if (n < kMinSize) return false;
+
+    std::vector<T> keys = sample_keys(a, n, comp);
+    if (keys.empty()) return false;
+
+    if constexpr (fill_ok_v<T, Compare>) {
+        // Целые с узким диапазоном: плотная гистограмма, корзина — x - min
+        using U = std::make_unsigned_t<T>;
+        // Ширина проверяется до + 1: у 64-битных min()..max() разность + 1 даёт 0
+        U lo = (U)keys.front();
+        U d = (U)keys.back() - lo;
+        if (d < kMaxRange) {
+            std::size_t span = (std::size_t)d + 1;
+            auto slot = [lo](T x) { return (std::size_t)(U)((U)x - lo); };
+            auto value = [lo](std::size_t s) { return (T)(U)(lo + (U)s); };
+            return counting_sort<true>(a, tmp, n, be, span, slot, value);
+        }
+    }
+
+    auto slot = [&](const T& x) { return key_slot(keys, x, comp); };
+    auto value = [&](std::size_t s) { return keys[s]; };
+    return counting_sort<fill_ok_v<T, Compare>>(a, tmp, n, be, keys.size(), slot, value);
+}
+
+} // namespace merge_lib
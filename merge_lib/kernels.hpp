@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "params.hpp"
+#include "simd_sort.hpp"
+
+namespace merge_lib {
+
+// Скалярное слияние без ветвлений: результат сравнения выбирает источник (cmov)
+// и сдвигает индексы, поэтому на случайных данных нет промахов предсказания
+template <class T, class Compare>
+T* merge_branchless(const T* a, const T* a_end, const T* b, const T* b_end, T* out, Compare comp) {
+    while (a != a_end && b != b_end) {
+        bool take_b = comp(*b, *a);
+        *out++ = *(take_b ? b : a);
+        a += !take_b;
+        b += take_b;
+    }
+    out = std::copy(a, a_end, out);
+    return std::copy(b, b_end, out);
+}
+
+template <class Compare>
+constexpr bool is_default_less_v = std::is_same<Compare, std::less<int>>::value
+                                || std::is_same<Compare, std::less<>>::value;
+
+// Слияние двух отсортированных диапазонов в out:
+// int + std::less — SIMD, арифметические типы — без ветвлений, остальное — std::merge
+template <class T, class Compare>
+T* merge_runs(const T* a, const T* a_end, const T* b, const T* b_end, T* out, Compare comp) {
+    if constexpr (std::is_same<T, int>::value && is_default_less_v<Compare>) {
+        if (simd::merge(a, a_end - a, b, b_end - b, out))
+            return out + (a_end - a) + (b_end - b);
+    }
+    if constexpr (std::is_arithmetic<T>::value)
+        return merge_branchless(a, a_end, b, b_end, out, comp);
+    else
+        return std::merge(a, a_end, b, b_end, out, comp);
+}
+
+// Сортировка вставками для маленьких диапазонов
+template <class T, class Compare>
+void insertion_sort(T* a, std::size_t n, Compare comp) {
+    for (std::size_t i = 1; i < n; i++) {
+        T x = std::move(a[i]);
+        std::size_t j = i;
+        for (; j > 0 && comp(x, a[j - 1]); j--)
+            a[j] = std::move(a[j - 1]);
+        a[j] = std::move(x);
+    }
+}
+
+// SIMD-лист есть только для int с обычным порядком
+template <class T, class Compare>
+bool leaf_sort_simd(T*, T*, std::size_t, bool, Compare) { return false; }
+
+inline bool leaf_sort_simd(int* a, int* tmp, std::size_t n, bool to_tmp, std::less<int>) {
+    return simd::sort_leaf(a, tmp, n, to_tmp);
+}
+
+inline bool leaf_sort_simd(int* a, int* tmp, std::size_t n, bool to_tmp, std::less<>) {
+    return simd::sort_leaf(a, tmp, n, to_tmp);
+}
+
+template <class T, class Compare>
+bool try_simd_leaf(T* a, T* tmp, std::size_t n, bool to_tmp, const Params& p, Compare comp) {
+    return p.leaf_algo == leaf_kind::simd && n <= p.simd_leaf
+        && leaf_sort_simd(a, tmp, n, to_tmp, comp);
+}
+
+// Последовательная сортировка [a, a + n) через буфер tmp (merge + copy-back)
+template <class T, class Compare>
+void sort_sequential(T* a, T* tmp, std::size_t n, const Params& p, Compare comp) {
+    if (try_simd_leaf(a, tmp, n, false, p, comp))
+        return;
+    if (n <= p.leaf) {
+        insertion_sort(a, n, comp);
+        return;
+    }
+
+    std::size_t m = n / 2;
+    sort_sequential(a, tmp, m, p, comp);
+    sort_sequential(a + m, tmp + m, n - m, p, comp);
+
+    merge_runs(a, a + m, a + m, a + n, tmp, comp);
+    std::copy(tmp, tmp + n, a);
+}
+
+// Ping-pong: буферы a и tmp меняются ролями по чётности уровня, copy-back нет.
+// Данные лежат в a; результат в tmp, если to_tmp, иначе в a.
+// Лишнее копирование возможно только в листьях (один проход по данным).
+template <class T, class Compare>
+void sort_ping_pong(T* a, T* tmp, std::size_t n, bool to_tmp, const Params& p, Compare comp) {
+    if (try_simd_leaf(a, tmp, n, to_tmp, p, comp))
+        return;
+    if (n <= p.leaf) {
+        insertion_sort(a, n, comp);
+        if (to_tmp) std::copy(a, a + n, tmp);
+        return;
+    }
+
+    std::size_t m = n / 2;
+    sort_ping_pong(a, tmp, m, !to_tmp, p, comp);
+    sort_ping_pong(a + m, tmp + m, n - m, !to_tmp, p, comp);
+
+    const T* src = to_tmp ? a : tmp;
+    T* dst = to_tmp ? tmp : a;
+    merge_runs(src, src + m, src + m, src + n, dst, comp);
+}
+
+} // namespace merge_lib
@@ -0,0 +1,132 @@
+#pragma once
+
+// Сортировка записей по ключу и argsort.
+//
+//   struct Record { std::uint64_t key; char payload[120]; };
+//   auto key = [](const Record& r) { return r.key; };
+//
+//   merge_lib::sort_by(records, be, key);           // записи двигаются на каждом уровне
+//   merge_lib::sort_by_key(records, be, key);       // сортируются пары (ключ, индекс),
+//                                                   // записи переставляются один раз
+//   auto idx = merge_lib::argsort(values, be);      // индексы в порядке возрастания
+//
+// Все варианты устойчивые: при равных ключах сохраняется исходный порядок.
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "parallel_for.hpp"
+
+namespace merge_lib {
+
+// Сравнение записей по извлечённому ключу
+template <class KeyFn, class Compare = std::less<>>
+struct key_compare {
+    KeyFn key;
+    Compare comp;
+
+    template <class T>
+    bool operator()(const T& a, const T& b) const { return comp(key(a), key(b)); }
+};
+
+// Компактная пара для режима ключ/индекс
+template <class K>
+struct key_index {
+    K key;
+    std::size_t index;
+};
+
+template <class T, class KeyFn>
+using key_type_t = std::decay_t<std::invoke_result_t<KeyFn, const T&>>;
+
+namespace key_detail {
+
+constexpr std::size_t kPermuteBlock = 1 << 14;
+
+// Пары (ключ, индекс), устойчиво отсортированные по ключу
+template <class Backend, class T, class KeyFn, class Compare>
+std::vector<key_index<key_type_t<T, KeyFn>>>
+sorted_keys(const std::vector<T>& data, Backend& be, KeyFn key, const Params& p, Compare comp) {
+    using K = key_type_t<T, KeyFn>;
+    std::size_t n = data.size();
+    std::vector<key_index<K>> keys(n);
+
+    std::size_t blocks = (n + kPermuteBlock - 1) / kPermuteBlock;
+    be.run([&] {
+        parallel_for(be, 0, blocks, [&](std::size_t b) {
+            std::size_t l = b * kPermuteBlock, r = std::min(n, l + kPermuteBlock);
+            for (std::size_t i = l; i < r; i++)
+                keys[i] = {key(data[i]), i};
+        });
+    });
+
+    auto by_key = [comp](const key_index<K>& a, const key_index<K>& b) { return comp(a.key, b.key); };
+    sort(keys, be, p, by_key);
+    return keys;
+}
+
+} // namespace key_detail
+
+// Сортировка записей по ключу key(x) с перемещением самих записей
+template <class Backend, class T, class KeyFn, class Compare = std::less<>>
+void sort_by(std::vector<T>& data, Backend& be, KeyFn key, const Params& p = {}, Compare comp = {}) {
+    sort(data, be, p, key_compare<KeyFn, Compare>{key, comp});
+}
+
+// Режим ключ/индекс: сортируются пары (ключ, индекс), затем записи
+// переставляются одним проходом. Для крупных записей это одна запись
+// каждой записи вместо log2(N) копирований по уровням слияния
+template <class Backend, class T, class KeyFn, class Compare = std::less<>>
+void sort_by_key(std::vector<T>& data, Backend& be, KeyFn key, const Params& p = {}, Compare comp = {}) {
+    using namespace key_detail;
+    std::size_t n = data.size();
+    if (n <= 1) return;
+
+    auto keys = sorted_keys(data, be, key, p, comp);
+
+    std::vector<T> out(n);
+    std::size_t blocks = (n + kPermuteBlock - 1) / kPermuteBlock;
+    be.run([&] {
+        parallel_for(be, 0, blocks, [&](std::size_t b) {
+            std::size_t l = b * kPermuteBlock, r = std::min(n, l + kPermuteBlock);
+            for (std::size_t i = l; i < r; i++)
+                out[i] = std::move(data[keys[i].index]);
+        });
+    });
+    data.swap(out);
+}
+
+// Перестановка, сортирующая data по ключу: data[idx[0]] — минимальный элемент
+template <class Backend, class T, class KeyFn, class Compare = std::less<>>
+std::vector<std::size_t> argsort_by(const std::vector<T>& data, Backend& be, KeyFn key,
+                                    const Params& p = {}, Compare comp = {})
+{
+    using namespace key_detail;
+    std::size_t n = data.size();
+    auto keys = sorted_keys(data, be, key, p, comp);
+
+    std::vector<std::size_t> idx(n);
+    std::size_t blocks = (n + kPermuteBlock - 1) / kPermuteBlock;
+    be.run([&] {
+        parallel_for(be, 0, blocks, [&](std::size_t b) {
+            std::size_t l = b * kPermuteBlock, r = std::min(n, l + kPermuteBlock);
+            for (std::size_t i = l; i < r; i++)
+                idx[i] = keys[i].index;
+        });
+    });
+    return idx;
+}
+
+template <class Backend, class T, class Compare = std::less<>>
+std::vector<std::size_t> argsort(const std::vector<T>& data, Backend& be, const Params& p = {},
+                                 Compare comp = {})
+{
+    return argsort_by(data, be, [](const T& x) -> const T& { return x; }, p, comp);
+}
+
+} // namespace merge_lib
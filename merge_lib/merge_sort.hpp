@@ -0,0 +1,144 @@
+#pragma once
+
+// Header-only merge sort с подключаемым бэкендом.
+//
+//   #include "merge_lib/merge_sort.hpp"
+//   #include "merge_lib/backend_omp.hpp"
+//
+//   merge_lib::omp_backend be;
+//   merge_lib::sort(data, be);
+//
+// Бэкенды: serial_backend, thread_backend (backend_thread.hpp),
+// omp_backend (backend_omp.hpp), tbb_backend (backend_tbb.hpp),
+// mpi_backend (backend_mpi.hpp).
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "backend_serial.hpp"
+#include "few_unique.hpp"
+#include "kernels.hpp"
+#include "natural_sort.hpp"
+#include "parallel_merge.hpp"
+#include "params.hpp"
+#include "trace.hpp"
+
+namespace merge_lib {
+
+// Узел дерева задач: половины сортируются через be.invoke, затем
+// параллельное слияние той же глубины (включая корень)
+template <class Backend, class T, class Compare>
+void sort_task(Backend& be, T* a, T* tmp, std::size_t n, int depth,
+               const Params& p, Compare comp)
+{
+    if (depth <= 0 || n < p.cutoff) {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::leaf, depth, a, n);
+        if (p.leaf_algo == leaf_kind::natural)
+            natural_sort(a, tmp, n, comp);
+        else
+            sort_sequential(a, tmp, n, p, comp);
+        return;
+    }
+
+    MERGE_LIB_TRACE_SCOPE(trace::phase::sort, depth, a, n);
+    std::size_t m = n / 2;
+
+    be.invoke([&] { sort_task(be, a, tmp, m, depth - 1, p, comp); },
+              [&] { sort_task(be, a + m, tmp + m, n - m, depth - 1, p, comp); });
+
+    // Адаптивный режим: половины уже по порядку — сливать нечего
+    // (m > 0: при cutoff <= 2 сюда доходят узлы из одного элемента)
+    if (p.leaf_algo == leaf_kind::natural && m > 0 && !comp(a[m], a[m - 1]))
+        return;
+
+    {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::merge, depth, a, n);
+        parallel_merge(be, a, m, a + m, n - m, tmp, depth, p, comp);
+    }
+    MERGE_LIB_TRACE_SCOPE(trace::phase::copy, depth, a, n);
+    parallel_copy(be, tmp, n, a, depth, p);
+}
+
+// То же без copy-back: результат в tmp, если to_tmp, иначе в a
+template <class Backend, class T, class Compare>
+void sort_task_ping_pong(Backend& be, T* a, T* tmp, std::size_t n, bool to_tmp, int depth,
+                         const Params& p, Compare comp)
+{
+    if (depth <= 0 || n < p.cutoff) {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::leaf, depth, a, n);
+        if (p.leaf_algo == leaf_kind::natural) {
+            natural_sort(a, tmp, n, comp);
+            if (to_tmp) std::copy(a, a + n, tmp);
+        } else {
+            sort_ping_pong(a, tmp, n, to_tmp, p, comp);
+        }
+        return;
+    }
+
+    MERGE_LIB_TRACE_SCOPE(trace::phase::sort, depth, a, n);
+    std::size_t m = n / 2;
+
+    be.invoke([&] { sort_task_ping_pong(be, a, tmp, m, !to_tmp, depth - 1, p, comp); },
+              [&] { sort_task_ping_pong(be, a + m, tmp + m, n - m, !to_tmp, depth - 1, p, comp); });
+
+    const T* src = to_tmp ? a : tmp;
+    T* dst = to_tmp ? tmp : a;
+    if (p.leaf_algo == leaf_kind::natural && m > 0 && !comp(src[m], src[m - 1])) {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::copy, depth, a, n);
+        parallel_copy(be, src, n, dst, depth, p);
+    } else {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::merge, depth, a, n);
+        parallel_merge(be, src, m, src + m, n - m, dst, depth, p, comp);
+    }
+}
+
+// Сортировка [first, last) с внешним буфером tmp того же размера
+template <class Backend, class T, class Compare = std::less<T>>
+sort_path sort(T* first, T* last, T* tmp, Backend& be, const Params& p = {}, Compare comp = {}) {
+    std::size_t n = last - first;
+    if (n <= 1) return sort_path::merge;
+    if (p.few_unique && few_unique_sort(first, tmp, n, be, comp))
+        return sort_path::counting;
+
+    int depth = resolve_depth(p, be.concurrency());
+    be.run([&] {
+        if (p.ping_pong)
+            sort_task_ping_pong(be, first, tmp, n, false, depth, p, comp);
+        else
+            sort_task(be, first, tmp, n, depth, p, comp);
+    });
+    return sort_path::merge;
+}
+
+template <class Backend, class T, class Compare = std::less<T>>
+sort_path sort(std::vector<T>& a, Backend& be, const Params& p = {}, Compare comp = {}) {
+    std::vector<T> tmp(a.size());
+    return sort(a.data(), a.data() + a.size(), tmp.data(), be, p, comp);
+}
+
+template <class T>
+void sort(std::vector<T>& a) {
+    serial_backend be;
+    sort(a, be);
+}
+
+// Слияние уже отсортированных подряд идущих серий a[bounds[i], bounds[i+1])
+// деревом: серии [lo, hi) сливаются попарно через be.invoke
+template <class Backend, class T, class Compare>
+void merge_run_tree(Backend& be, T* a, T* tmp, const std::vector<std::size_t>& bounds,
+                    std::size_t lo, std::size_t hi, int depth, const Params& p, Compare comp)
+{
+    if (hi - lo <= 1) return;
+
+    std::size_t mid = (lo + hi) / 2;
+    be.invoke([&] { merge_run_tree(be, a, tmp, bounds, lo, mid, depth - 1, p, comp); },
+              [&] { merge_run_tree(be, a, tmp, bounds, mid, hi, depth - 1, p, comp); });
+
+    std::size_t l = bounds[lo], m = bounds[mid], r = bounds[hi];
+    parallel_merge(be, a + l, m - l, a + m, r - m, tmp + l, depth, p, comp);
+    parallel_copy(be, tmp + l, r - l, a + l, depth, p);
+}
+
+} // namespace merge_lib
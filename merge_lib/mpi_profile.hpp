@@ -0,0 +1,403 @@
+#pragma once
+
+// Профиль обменов MPI через PMPI: каждый вызов точка-точка, ожидания,
+// опроса и коллектива перехватывается и замеряется, а при MPI_Finalize
+// rank 0 печатает в stderr таблицу по рангам.
+//
+//   mpicxx -DMERGE_LIB_MPI_PROFILE ... merge_mpi.cpp
+//
+// Подключается из mpi_transport.hpp, поэтому включение флагом достаточно
+// для всех MPI-программ репозитория. Обёртки — слабые символы: их можно
+// подключить в нескольких единицах трансляции, а из исполняемого файла они
+// перекрывают функции libmpi.
+//
+// Время по рангу делится на:
+//   send     — блокирующие MPI_Send;
+//   recv     — блокирующие MPI_Recv и MPI_Probe;
+//   wait     — MPI_Wait* по неблокирующим запросам;
+//   idle     — цикл опроса: от неудачного MPI_Iprobe / MPI_Test* до следующего вызова MPI;
+//   coll     — коллективы;
+//   compute  — остальное от MPI_Init до MPI_Finalize.
+// Байты точка-точка считаются по факту (принятые — по статусу), у коллективов —
+// логический объём этого ранга (что отдал и что получил).
+// Счётчики без синхронизации: MPI вызывает один поток ранга (FUNNELED).
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+namespace merge_lib {
+namespace mpi_profile {
+
+struct counters {
+    double start = 0, total = 0;
+    double send = 0, recv = 0, wait = 0, idle = 0, coll = 0;
+    double sent_bytes = 0, sent_msgs = 0, recv_bytes = 0, recv_msgs = 0;
+    double coll_bytes = 0, coll_calls = 0;
+    double spin_from = -1;   // начало текущего цикла опроса, -1 — не опрашиваем
+};
+
+constexpr int kFields = 13;   // double-поля counters без spin_from, для PMPI_Gather
+
+inline counters& local() {
+    static counters c;
+    return c;
+}
+
+// Незавершённые MPI_Irecv: их байты учитываются при завершении
+inline std::unordered_set<MPI_Request>& pending_recvs() {
+    static std::unordered_set<MPI_Request> s;
+    return s;
+}
+
+// Вход в любой перехваченный вызов закрывает цикл опроса
+inline double enter() {
+    counters& c = local();
+    double t = PMPI_Wtime();
+    if (c.spin_from >= 0) {
+        c.idle += t - c.spin_from;
+        c.spin_from = -1;
+    }
+    return t;
+}
+
+inline double bytes(int count, MPI_Datatype type) {
+    int size = 0;
+    PMPI_Type_size(type, &size);
+    return (double)count * size;
+}
+
+inline double received(const MPI_Status& status) {
+    int count = 0;
+    PMPI_Get_count(&status, MPI_BYTE, &count);
+    return count == MPI_UNDEFINED ? 0 : count;
+}
+
+// Учёт завершённых запросов: копия дескрипторов снята до вызова,
+// потому что MPI обнуляет их в MPI_REQUEST_NULL
+inline void completed(MPI_Request request, const MPI_Status& status) {
+    auto& s = pending_recvs();
+    auto it = s.find(request);
+    if (it == s.end()) return;
+    s.erase(it);
+    local().recv_bytes += received(status);
+    local().recv_msgs++;
+}
+
+inline void collective(double t0, double sent, double got) {
+    counters& c = local();
+    c.coll += PMPI_Wtime() - t0;
+    c.coll_bytes += sent + got;
+    c.coll_calls++;
+}
+
+inline int rank_of(MPI_Comm comm) {
+    int r;
+    PMPI_Comm_rank(comm, &r);
+    return r;
+}
+
+inline int size_of(MPI_Comm comm) {
+    int s;
+    PMPI_Comm_size(comm, &s);
+    return s;
+}
+
+inline double sum_except(const int* counts, int n, int skip, MPI_Datatype type) {
+    double s = 0;
+    for (int i = 0; i < n; i++)
+        if (i != skip) s += bytes(counts[i], type);
+    return s;
+}
+
+// Таблица по рангам (формат как в *.md репозитория)
+inline void report() {
+    counters& c = local();
+    c.total = PMPI_Wtime() - c.start;
+    double mine[kFields] = {c.start, c.total, c.send, c.recv, c.wait, c.idle, c.coll,
+                            c.sent_bytes, c.sent_msgs, c.recv_bytes, c.recv_msgs,
+                            c.coll_bytes, c.coll_calls};
+
+    int rank = rank_of(MPI_COMM_WORLD), size = size_of(MPI_COMM_WORLD);
+    std::vector<double> all(rank == 0 ? (std::size_t)kFields * size : 0);
+    PMPI_Gather(mine, kFields, MPI_DOUBLE, all.data(), kFields, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank != 0) return;
+
+    std::fprintf(stderr, "\nПрофиль MPI (время в s, объём в MB)\n\n"
+                         "| rank | всего | compute | send | recv | wait | idle | coll "
+                         "| отправлено | сообщений | принято | сообщений | coll, MB | coll, вызовов |\n"
+                         "| :---: | :---: | :---: | :---: | :---: | :---: | :---: | :---: "
+                         "| :---: | :---: | :---: | :---: | :---: | :---: |\n");
+    for (int r = 0; r < size; r++) {
+        const double* f = &all[(std::size_t)r * kFields];
+        double mpi = f[2] + f[3] + f[4] + f[5] + f[6];
+        std::fprintf(stderr, "| %d | %.4f | %.4f | %.4f | %.4f | %.4f | %.4f | %.4f "
+                             "| %.2f | %.0f | %.2f | %.0f | %.2f | %.0f |\n",
+                     r, f[1], f[1] - mpi, f[2], f[3], f[4], f[5], f[6],
+                     f[7] / 1e6, f[8], f[9] / 1e6, f[10], f[11] / 1e6, f[12]);
+    }
+}
+
+} // namespace mpi_profile
+} // namespace merge_lib
+
+#define MERGE_LIB_PMPI extern "C" __attribute__((weak))
+
+// ---- Инициализация и завершение ----
+
+MERGE_LIB_PMPI int MPI_Init(int* argc, char*** argv) {
+    int rc = PMPI_Init(argc, argv);
+    merge_lib::mpi_profile::local().start = PMPI_Wtime();
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Init_thread(int* argc, char*** argv, int required, int* provided) {
+    int rc = PMPI_Init_thread(argc, argv, required, provided);
+    merge_lib::mpi_profile::local().start = PMPI_Wtime();
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Finalize() {
+    merge_lib::mpi_profile::enter();
+    merge_lib::mpi_profile::report();
+    return PMPI_Finalize();
+}
+
+// ---- Точка-точка ----
+
+MERGE_LIB_PMPI int MPI_Send(const void* buf, int count, MPI_Datatype type, int dest, int tag, MPI_Comm comm) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Send(buf, count, type, dest, tag, comm);
+    counters& c = local();
+    c.send += PMPI_Wtime() - t0;
+    c.sent_bytes += bytes(count, type);
+    c.sent_msgs++;
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Isend(const void* buf, int count, MPI_Datatype type, int dest, int tag, MPI_Comm comm,
+                             MPI_Request* request)
+{
+    using namespace merge_lib::mpi_profile;
+    enter();
+    counters& c = local();
+    c.sent_bytes += bytes(count, type);
+    c.sent_msgs++;
+    return PMPI_Isend(buf, count, type, dest, tag, comm, request);
+}
+
+MERGE_LIB_PMPI int MPI_Recv(void* buf, int count, MPI_Datatype type, int src, int tag, MPI_Comm comm,
+                            MPI_Status* status)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    MPI_Status own;
+    if (status == MPI_STATUS_IGNORE) status = &own;
+    int rc = PMPI_Recv(buf, count, type, src, tag, comm, status);
+    counters& c = local();
+    c.recv += PMPI_Wtime() - t0;
+    c.recv_bytes += received(*status);
+    c.recv_msgs++;
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Irecv(void* buf, int count, MPI_Datatype type, int src, int tag, MPI_Comm comm,
+                             MPI_Request* request)
+{
+    using namespace merge_lib::mpi_profile;
+    enter();
+    int rc = PMPI_Irecv(buf, count, type, src, tag, comm, request);
+    pending_recvs().insert(*request);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Probe(int src, int tag, MPI_Comm comm, MPI_Status* status) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Probe(src, tag, comm, status);
+    local().recv += PMPI_Wtime() - t0;
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Iprobe(int src, int tag, MPI_Comm comm, int* flag, MPI_Status* status) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Iprobe(src, tag, comm, flag, status);
+    if (!*flag) local().spin_from = t0;
+    return rc;
+}
+
+// ---- Ожидание и опрос запросов ----
+
+MERGE_LIB_PMPI int MPI_Wait(MPI_Request* request, MPI_Status* status) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    MPI_Request req = *request;
+    MPI_Status own;
+    if (status == MPI_STATUS_IGNORE) status = &own;
+    int rc = PMPI_Wait(request, status);
+    local().wait += PMPI_Wtime() - t0;
+    completed(req, *status);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[]) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    std::vector<MPI_Request> reqs(requests, requests + count);
+    std::vector<MPI_Status> own;
+    if (statuses == MPI_STATUSES_IGNORE) {
+        own.resize(count);
+        statuses = own.data();
+    }
+    int rc = PMPI_Waitall(count, requests, statuses);
+    local().wait += PMPI_Wtime() - t0;
+    for (int i = 0; i < count; i++) completed(reqs[i], statuses[i]);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Waitany(int count, MPI_Request requests[], int* index, MPI_Status* status) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    std::vector<MPI_Request> reqs(requests, requests + count);
+    MPI_Status own;
+    if (status == MPI_STATUS_IGNORE) status = &own;
+    int rc = PMPI_Waitany(count, requests, index, status);
+    local().wait += PMPI_Wtime() - t0;
+    if (*index != MPI_UNDEFINED) completed(reqs[*index], *status);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Test(MPI_Request* request, int* flag, MPI_Status* status) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    MPI_Request req = *request;
+    MPI_Status own;
+    if (status == MPI_STATUS_IGNORE) status = &own;
+    int rc = PMPI_Test(request, flag, status);
+    if (*flag) completed(req, *status);
+    else local().spin_from = t0;
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Testall(int count, MPI_Request requests[], int* flag, MPI_Status statuses[]) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    std::vector<MPI_Request> reqs(requests, requests + count);
+    std::vector<MPI_Status> own;
+    if (statuses == MPI_STATUSES_IGNORE) {
+        own.resize(count);
+        statuses = own.data();
+    }
+    int rc = PMPI_Testall(count, requests, flag, statuses);
+    if (*flag) {
+        for (int i = 0; i < count; i++) completed(reqs[i], statuses[i]);
+    } else {
+        local().spin_from = t0;
+    }
+    return rc;
+}
+
+// ---- Коллективы ----
+
+MERGE_LIB_PMPI int MPI_Barrier(MPI_Comm comm) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Barrier(comm);
+    collective(t0, 0, 0);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Bcast(void* buf, int count, MPI_Datatype type, int root, MPI_Comm comm) {
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Bcast(buf, count, type, root, comm);
+    double b = bytes(count, type);
+    if (rank_of(comm) == root) collective(t0, b * (size_of(comm) - 1), 0);
+    else collective(t0, 0, b);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Scatterv(const void* send, const int counts[], const int displs[], MPI_Datatype send_type,
+                                void* recv, int recv_count, MPI_Datatype recv_type, int root, MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Scatterv(send, counts, displs, send_type, recv, recv_count, recv_type, root, comm);
+    if (rank_of(comm) == root) collective(t0, sum_except(counts, size_of(comm), root, send_type), 0);
+    else collective(t0, 0, bytes(recv_count, recv_type));
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Gatherv(const void* send, int send_count, MPI_Datatype send_type, void* recv,
+                               const int counts[], const int displs[], MPI_Datatype recv_type, int root,
+                               MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Gatherv(send, send_count, send_type, recv, counts, displs, recv_type, root, comm);
+    if (rank_of(comm) == root) collective(t0, 0, sum_except(counts, size_of(comm), root, recv_type));
+    else collective(t0, bytes(send_count, send_type), 0);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Alltoall(const void* send, int send_count, MPI_Datatype send_type,
+                                void* recv, int recv_count, MPI_Datatype recv_type, MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Alltoall(send, send_count, send_type, recv, recv_count, recv_type, comm);
+    int others = size_of(comm) - 1;
+    collective(t0, bytes(send_count, send_type) * others, bytes(recv_count, recv_type) * others);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Alltoallv(const void* send, const int send_counts[], const int send_displs[],
+                                 MPI_Datatype send_type, void* recv, const int recv_counts[],
+                                 const int recv_displs[], MPI_Datatype recv_type, MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Alltoallv(send, send_counts, send_displs, send_type,
+                            recv, recv_counts, recv_displs, recv_type, comm);
+    int rank = rank_of(comm), size = size_of(comm);
+    collective(t0, sum_except(send_counts, size, rank, send_type), sum_except(recv_counts, size, rank, recv_type));
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Allgather(const void* send, int send_count, MPI_Datatype send_type,
+                                 void* recv, int recv_count, MPI_Datatype recv_type, MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Allgather(send, send_count, send_type, recv, recv_count, recv_type, comm);
+    int others = size_of(comm) - 1;
+    collective(t0, bytes(send_count, send_type) * others, bytes(recv_count, recv_type) * others);
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Allgatherv(const void* send, int send_count, MPI_Datatype send_type, void* recv,
+                                  const int counts[], const int displs[], MPI_Datatype recv_type, MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Allgatherv(send, send_count, send_type, recv, counts, displs, recv_type, comm);
+    int rank = rank_of(comm), size = size_of(comm);
+    collective(t0, bytes(send_count, send_type) * (size - 1), sum_except(counts, size, rank, recv_type));
+    return rc;
+}
+
+MERGE_LIB_PMPI int MPI_Allreduce(const void* send, void* recv, int count, MPI_Datatype type, MPI_Op op,
+                                 MPI_Comm comm)
+{
+    using namespace merge_lib::mpi_profile;
+    double t0 = enter();
+    int rc = PMPI_Allreduce(send, recv, count, type, op, comm);
+    collective(t0, bytes(count, type), bytes(count, type));
+    return rc;
+}
+
+#undef MERGE_LIB_PMPI
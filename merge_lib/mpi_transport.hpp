@@ -0,0 +1,307 @@
+#pragma once
+
+#include <mpi.h>
+
+#ifdef MERGE_LIB_MPI_PROFILE
+#include "mpi_profile.hpp"   // перехват PMPI, таблица по рангам при MPI_Finalize
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <type_traits>
+#include <vector>
+
+namespace merge_lib {
+
+// Соответствие типов C++ и MPI. Для остальных типов (записи с ключом и
+// данными) — непрерывный блок байт, создаётся один раз при первом вызове
+template <class T> MPI_Datatype mpi_type() {
+    static_assert(std::is_trivially_copyable<T>::value, "mpi_type: тип должен копироваться побайтно");
+    static MPI_Datatype type = [] {
+        MPI_Datatype t;
+        MPI_Type_contiguous((int)sizeof(T), MPI_BYTE, &t);
+        MPI_Type_commit(&t);
+        return t;
+    }();
+    return type;
+}
+template <> inline MPI_Datatype mpi_type<int>() { return MPI_INT; }
+template <> inline MPI_Datatype mpi_type<unsigned>() { return MPI_UNSIGNED; }
+template <> inline MPI_Datatype mpi_type<long>() { return MPI_LONG; }
+template <> inline MPI_Datatype mpi_type<long long>() { return MPI_LONG_LONG; }
+template <> inline MPI_Datatype mpi_type<unsigned long>() { return MPI_UNSIGNED_LONG; }
+template <> inline MPI_Datatype mpi_type<unsigned long long>() { return MPI_UNSIGNED_LONG_LONG; }
+template <> inline MPI_Datatype mpi_type<float>() { return MPI_FLOAT; }
+template <> inline MPI_Datatype mpi_type<double>() { return MPI_DOUBLE; }
+
+// Счётчики в MPI 3.x — int, поэтому длинные серии идут несколькими сообщениями
+// по kMaxMessage элементов. Все куски, кроме последнего, полные; последний
+// короче kMaxMessage (возможно, пустой) — по нему получатель видит конец.
+// Серии короче kMaxMessage, как и раньше, — одно сообщение.
+#ifndef MERGE_LIB_MPI_MAX_MESSAGE
+#define MERGE_LIB_MPI_MAX_MESSAGE (std::size_t(1) << 30)
+#endif
+
+constexpr std::size_t kMaxMessage = MERGE_LIB_MPI_MAX_MESSAGE;
+
+// Тег кусков в коллективах ниже, когда они идут точка-точка
+constexpr int TAG_LARGE_TRANSFER = 101;
+
+// Неблокирующая отправка n элементов кусками; запросы добавляются в requests
+template <class T>
+void isend_chunks(const T* buf, std::size_t n, int dest, int tag, MPI_Comm comm,
+                  std::vector<MPI_Request>& requests)
+{
+    for (std::size_t off = 0;; off += kMaxMessage) {
+        std::size_t count = std::min(n - off, kMaxMessage);
+        requests.emplace_back();
+        MPI_Isend(buf + off, (int)count, mpi_type<T>(), dest, tag, comm, &requests.back());
+        if (count < kMaxMessage) break;
+    }
+}
+
+// Неблокирующий приём ровно n элементов с той же нарезкой, что у isend_chunks
+template <class T>
+void irecv_chunks(T* buf, std::size_t n, int src, int tag, MPI_Comm comm,
+                  std::vector<MPI_Request>& requests)
+{
+    for (std::size_t off = 0;; off += kMaxMessage) {
+        std::size_t count = std::min(n - off, kMaxMessage);
+        requests.emplace_back();
+        MPI_Irecv(buf + off, (int)count, mpi_type<T>(), src, tag, comm, &requests.back());
+        if (count < kMaxMessage) break;
+    }
+}
+
+// Вектор передаётся без отдельного сообщения с размером: получатель узнаёт
+// размер через MPI_Probe + MPI_Get_count (для длинных — по кускам)
+template <class T>
+void send_vector(int dest, int tag, const std::vector<T>& data, MPI_Comm comm = MPI_COMM_WORLD) {
+    if (data.size() < kMaxMessage) {
+        MPI_Send(data.data(), (int)data.size(), mpi_type<T>(), dest, tag, comm);
+        return;
+    }
+    std::vector<MPI_Request> requests;
+    isend_chunks(data.data(), data.size(), dest, tag, comm, requests);
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+// Размер ожидающего сообщения (одного куска); status заполняется источником и тегом
+template <class T>
+std::size_t probe_count(int src, int tag, MPI_Status& status, MPI_Comm comm = MPI_COMM_WORLD) {
+    MPI_Probe(src, tag, comm, &status);
+    int count = 0;
+    MPI_Get_count(&status, mpi_type<T>(), &count);
+    return (std::size_t)count;
+}
+
+template <class T = int>
+std::vector<T> recv_vector(int src, int tag, MPI_Comm comm = MPI_COMM_WORLD, MPI_Status* out_status = nullptr) {
+    MPI_Status status;
+    std::vector<T> data;
+    for (;;) {
+        std::size_t count = probe_count<T>(src, tag, status, comm);
+        // Остальные куски — именно от того, чьё сообщение нашёл probe (src/tag могут быть ANY)
+        src = status.MPI_SOURCE;
+        tag = status.MPI_TAG;
+        std::size_t off = data.size();
+        data.resize(off + count);
+        MPI_Recv(data.data() + off, (int)count, mpi_type<T>(), src, tag, comm, &status);
+        if (count < kMaxMessage) break;
+    }
+    if (out_status) *out_status = status;
+    return data;
+}
+
+// Приём сразу в заранее выделенный буфер; возвращает число принятых элементов
+template <class T>
+std::size_t recv_into(T* buf, std::size_t capacity, int src, int tag, MPI_Comm comm = MPI_COMM_WORLD,
+                      MPI_Status* out_status = nullptr)
+{
+    MPI_Status status;
+    std::size_t off = 0;
+    for (;;) {
+        std::size_t cap = std::min(capacity - off, kMaxMessage);
+        MPI_Recv(buf + off, (int)cap, mpi_type<T>(), src, tag, comm, &status);
+        src = status.MPI_SOURCE;
+        tag = status.MPI_TAG;
+        int count = 0;
+        MPI_Get_count(&status, mpi_type<T>(), &count);
+        off += count;
+        if ((std::size_t)count < kMaxMessage) break;
+    }
+    if (out_status) *out_status = status;
+    return off;
+}
+
+// Для ожидания в MPI_Waitany: неблокирующе принимается только первый кусок
+// серии из n элементов, остальные (если n >= kMaxMessage) — recv_rest после него
+template <class T>
+void irecv_first(T* buf, std::size_t n, int src, int tag, MPI_Comm comm, MPI_Request* request) {
+    MPI_Irecv(buf, (int)std::min(n, kMaxMessage), mpi_type<T>(), src, tag, comm, request);
+}
+
+template <class T>
+void recv_rest(T* buf, std::size_t n, int src, int tag, MPI_Comm comm = MPI_COMM_WORLD) {
+    if (n < kMaxMessage) return;
+    recv_into(buf + kMaxMessage, n - kMaxMessage, src, tag, comm);
+}
+
+// Сдвиги по размерам
+inline std::vector<std::size_t> displacements(const std::vector<std::size_t>& counts) {
+    std::vector<std::size_t> displs(counts.size(), 0);
+    for (std::size_t i = 1; i < counts.size(); i++)
+        displs[i] = displs[i - 1] + counts[i - 1];
+    return displs;
+}
+
+namespace transport_detail {
+
+// Коллективы MPI 3.x принимают int-счётчики и int-сдвиги; порог тот же, что у кусков
+inline bool fits_int(const std::vector<std::size_t>& counts) {
+    std::size_t total = 0;
+    for (auto c : counts) total += c;
+    return total < kMaxMessage;
+}
+
+inline std::vector<int> to_int(const std::vector<std::size_t>& v) {
+    return std::vector<int>(v.begin(), v.end());
+}
+
+} // namespace transport_detail
+
+// MPI_Scatterv с size_t-счётчиками; counts одинаковы на всех рангах.
+// Если сумма не влезает в int — отправки root кусками точка-точка
+template <class T>
+void scatterv(const T* send, const std::vector<std::size_t>& counts, T* recv, int root, MPI_Comm comm,
+              int tag = TAG_LARGE_TRANSFER)
+{
+    using namespace transport_detail;
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    auto displs = displacements(counts);
+
+    if (fits_int(counts)) {
+        auto c = to_int(counts), d = to_int(displs);
+        MPI_Scatterv(send, c.data(), d.data(), mpi_type<T>(), recv, c[rank], mpi_type<T>(), root, comm);
+        return;
+    }
+
+    std::vector<MPI_Request> requests;
+    if (rank == root) {
+        for (int i = 0; i < size; i++)
+            if (i != root) isend_chunks(send + displs[i], counts[i], i, tag, comm, requests);
+        std::copy(send + displs[root], send + displs[root] + counts[root], recv);
+    } else {
+        irecv_chunks(recv, counts[rank], root, tag, comm, requests);
+    }
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+// MPI_Gatherv с size_t-счётчиками; counts одинаковы на всех рангах
+template <class T>
+void gatherv(const T* send, const std::vector<std::size_t>& counts, T* recv, int root, MPI_Comm comm,
+             int tag = TAG_LARGE_TRANSFER)
+{
+    using namespace transport_detail;
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    auto displs = displacements(counts);
+
+    if (fits_int(counts)) {
+        auto c = to_int(counts), d = to_int(displs);
+        MPI_Gatherv(send, c[rank], mpi_type<T>(), recv, c.data(), d.data(), mpi_type<T>(), root, comm);
+        return;
+    }
+
+    std::vector<MPI_Request> requests;
+    if (rank == root) {
+        for (int i = 0; i < size; i++)
+            if (i != root) irecv_chunks(recv + displs[i], counts[i], i, tag, comm, requests);
+        std::copy(send, send + counts[root], recv + displs[root]);
+    } else {
+        isend_chunks(send, counts[rank], root, tag, comm, requests);
+    }
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+// MPI_Alltoallv с size_t-счётчиками. Обмен точка-точка выбирается,
+// если хоть у одного ранга суммы не влезают в int (решение общее — Allreduce)
+template <class T>
+void alltoallv(const T* send, const std::vector<std::size_t>& send_counts,
+               T* recv, const std::vector<std::size_t>& recv_counts, MPI_Comm comm, int tag = TAG_LARGE_TRANSFER)
+{
+    using namespace transport_detail;
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    auto send_displs = displacements(send_counts), recv_displs = displacements(recv_counts);
+
+    int local_fits = fits_int(send_counts) && fits_int(recv_counts), all_fit = 0;
+    MPI_Allreduce(&local_fits, &all_fit, 1, MPI_INT, MPI_LAND, comm);
+
+    if (all_fit) {
+        auto sc = to_int(send_counts), sd = to_int(send_displs);
+        auto rc = to_int(recv_counts), rd = to_int(recv_displs);
+        MPI_Alltoallv(send, sc.data(), sd.data(), mpi_type<T>(),
+                      recv, rc.data(), rd.data(), mpi_type<T>(), comm);
+        return;
+    }
+
+    std::vector<MPI_Request> requests;
+    for (int i = 0; i < size; i++) {
+        if (i == rank) continue;
+        irecv_chunks(recv + recv_displs[i], recv_counts[i], i, tag, comm, requests);
+        isend_chunks(send + send_displs[i], send_counts[i], i, tag, comm, requests);
+    }
+    std::copy(send + send_displs[rank], send + send_displs[rank] + send_counts[rank], recv + recv_displs[rank]);
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+// Неблокирующие отправки: буфер принадлежит набору, пока отправка не завершена,
+// поэтому master может раздать задачи нескольким воркерам и не ждать каждую
+template <class T>
+class send_requests {
+public:
+    explicit send_requests(MPI_Comm comm = MPI_COMM_WORLD) : comm_(comm) {}
+
+    ~send_requests() { wait_all(); }
+
+    void isend(int dest, int tag, std::vector<T> data) {
+        pending_.push_back({std::move(data), {}});
+        auto& p = pending_.back();
+        isend_chunks(p.data.data(), p.data.size(), dest, tag, comm_, p.requests);
+    }
+
+    // Освободить буферы завершённых отправок
+    void reap() {
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            int done = 0;
+            MPI_Testall((int)it->requests.size(), it->requests.data(), &done, MPI_STATUSES_IGNORE);
+            it = done ? pending_.erase(it) : std::next(it);
+        }
+    }
+
+    void wait_all() {
+        for (auto& p : pending_)
+            MPI_Waitall((int)p.requests.size(), p.requests.data(), MPI_STATUSES_IGNORE);
+        pending_.clear();
+    }
+
+    std::size_t size() const { return pending_.size(); }
+
+private:
+    struct pending {
+        std::vector<T> data;
+        std::vector<MPI_Request> requests;  // по запросу на кусок
+    };
+
+    MPI_Comm comm_;
+    std::list<pending> pending_;  // list: адреса буферов не меняются
+};
+
+} // namespace merge_lib
@@ -0,0 +1,176 @@
+#pragma once
+
+// K-way слияние отсортированных серий за один проход.
+//
+//   std::vector<merge_lib::run_ref<int>> runs = {{a, a + na}, {b, b + nb}, ...};
+//   merge_lib::multiway_merge(be, runs, out);
+//
+// Последовательно серии сливает дерево проигравших (loser_tree): на каждый
+// элемент log2(k) сравнений по пути от листа к корню. Параллельно выход
+// делится на равные куски выбором по нескольким последовательностям
+// (multisequence_select), и каждый поток пишет свой непересекающийся кусок.
+// При равных ключах раньше идёт серия с меньшим номером (слияние устойчивое).
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "parallel_for.hpp"
+
+namespace merge_lib {
+
+template <class T>
+struct run_ref {
+    const T* first;
+    const T* last;
+
+    std::size_t size() const { return last - first; }
+};
+
+// Источник для loser_tree поверх диапазона в памяти
+template <class T>
+struct range_source {
+    const T* cur;
+    const T* end;
+
+    bool empty() const { return cur == end; }
+    const T& front() const { return *cur; }
+    void pop() { ++cur; }
+};
+
+// Дерево проигравших над k источниками с empty()/front()/pop().
+// Узлы 1..k-1 хранят проигравшего, tree_[0] — текущего победителя;
+// пустой источник считается бесконечно большим
+template <class Source, class Compare>
+class loser_tree {
+public:
+    loser_tree(std::vector<Source>& src, Compare comp)
+        : src_(src), comp_(comp), k_(src.size()), tree_(std::max<std::size_t>(1, k_))
+    {
+        // Победители поддеревьев снизу вверх, листья — k_..2k_-1
+        std::vector<std::size_t> win(2 * k_);
+        for (std::size_t i = 0; i < k_; i++) win[k_ + i] = i;
+        for (std::size_t node = k_ > 0 ? k_ - 1 : 0; node >= 1; node--) {
+            std::size_t l = win[2 * node], r = win[2 * node + 1];
+            bool l_wins = before(l, r);
+            win[node] = l_wins ? l : r;
+            tree_[node] = l_wins ? r : l;
+        }
+        tree_[0] = k_ > 0 ? win[1] : 0;
+    }
+
+    bool empty() const { return k_ == 0 || src_[tree_[0]].empty(); }
+    const auto& front() const { return src_[tree_[0]].front(); }
+    std::size_t winner() const { return tree_[0]; }
+
+    void pop() {
+        std::size_t w = tree_[0];
+        src_[w].pop();
+        for (std::size_t node = (w + k_) / 2; node >= 1; node /= 2) {
+            if (before(tree_[node], w))
+                std::swap(tree_[node], w);
+        }
+        tree_[0] = w;
+    }
+
+private:
+    bool before(std::size_t a, std::size_t b) const {
+        if (src_[a].empty()) return false;
+        if (src_[b].empty()) return true;
+        if (comp_(src_[a].front(), src_[b].front())) return true;
+        if (comp_(src_[b].front(), src_[a].front())) return false;
+        return a < b;
+    }
+
+    std::vector<Source>& src_;
+    Compare comp_;
+    std::size_t k_;
+    std::vector<std::size_t> tree_;
+};
+
+// Последовательное k-way слияние в out
+template <class T, class Compare = std::less<T>>
+void multiway_merge_seq(const std::vector<run_ref<T>>& runs, T* out, Compare comp = {}) {
+    std::vector<range_source<T>> src;
+    for (auto& r : runs)
+        src.push_back({r.first, r.last});
+
+    if (src.size() == 1) {
+        std::copy(src[0].cur, src[0].end, out);
+        return;
+    }
+
+    loser_tree<range_source<T>, Compare> tree(src, comp);
+    while (!tree.empty()) {
+        *out++ = tree.front();
+        tree.pop();
+    }
+}
+
+// Выбор по нескольким последовательностям: split[i] — сколько элементов
+// серии i входит в первые rank элементов слияния (сумма split равна rank).
+// Ранг элемента runs[i][j] — j плюс число элементов других серий перед ним
+// (в сериях с меньшим номером равные идут раньше); split[i] — первый j с рангом >= rank.
+// O(k^2 log^2 n) сравнений — для числа серий порядка числа потоков это мелочь
+template <class T, class Compare = std::less<T>>
+std::vector<std::size_t> multisequence_select(const std::vector<run_ref<T>>& runs, std::size_t rank,
+                                              Compare comp = {})
+{
+    std::size_t k = runs.size();
+    std::vector<std::size_t> split(k);
+
+    auto rank_of = [&](std::size_t i, std::size_t j) {
+        const T& x = runs[i].first[j];
+        std::size_t r = j;
+        for (std::size_t m = 0; m < k; m++) {
+            if (m < i) r += std::upper_bound(runs[m].first, runs[m].last, x, comp) - runs[m].first;
+            if (m > i) r += std::lower_bound(runs[m].first, runs[m].last, x, comp) - runs[m].first;
+        }
+        return r;
+    };
+
+    for (std::size_t i = 0; i < k; i++) {
+        std::size_t lo = 0, hi = runs[i].size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (rank_of(i, mid) < rank) lo = mid + 1;
+            else hi = mid;
+        }
+        split[i] = lo;
+    }
+    return split;
+}
+
+// Параллельное k-way слияние: выход режется на be.concurrency() равных кусков,
+// границы кусков во входах находит multisequence_select
+template <class Backend, class T, class Compare = std::less<T>>
+void multiway_merge(Backend& be, const std::vector<run_ref<T>>& runs, T* out, Compare comp = {}) {
+    std::size_t total = 0;
+    for (auto& r : runs) total += r.size();
+    if (total == 0) return;
+
+    std::size_t parts = std::max<std::size_t>(1, std::min<std::size_t>(be.concurrency(), total));
+    std::vector<std::vector<std::size_t>> bounds(parts + 1);
+    bounds[0].assign(runs.size(), 0);
+    for (auto& r : runs) bounds[parts].push_back(r.size());
+
+    be.run([&] {
+        parallel_for(be, 1, parts, [&](std::size_t t) {
+            bounds[t] = multisequence_select(runs, total * t / parts, comp);
+        });
+
+        parallel_for(be, 0, parts, [&](std::size_t t) {
+            std::vector<run_ref<T>> slice;
+            for (std::size_t i = 0; i < runs.size(); i++) {
+                const T* base = runs[i].first;
+                if (bounds[t][i] < bounds[t + 1][i])
+                    slice.push_back({base + bounds[t][i], base + bounds[t + 1][i]});
+            }
+            if (!slice.empty())
+                multiway_merge_seq(slice, out + total * t / parts, comp);
+        });
+    });
+}
+
+} // namespace merge_lib
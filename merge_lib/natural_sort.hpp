@@ -0,0 +1,210 @@
+#pragma once
+
+// Адаптивная сортировка слиянием естественных серий (powersort).
+//
+// Входной массив разбивается на уже упорядоченные серии: неубывающие берутся
+// как есть, строго убывающие разворачиваются, короткие дополняются вставками
+// до kMinRun (для int — SIMD-сортировкой блока kSimdRun). Порядок слияний
+// задаёт powersort: у границы двух соседних серий есть «мощность» (глубина
+// узла в почти оптимальном дереве слияний), серии на стеке сливаются, пока
+// мощность вершины больше новой. Слияние с «галопом»:
+// уже стоящие на месте начало левой и конец правой серии не трогаются, а длинные
+// выигрышные полосы копируются блоком после экспоненциального поиска. Для
+// арифметических типов перемешанные серии сливаются обычным merge_runs.
+//
+// Отсортированный вход — одна серия, O(n) сравнений и ни одного перемещения.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "kernels.hpp"
+
+namespace merge_lib {
+
+namespace natural_detail {
+
+constexpr std::size_t kMinRun = 32;     // короче — дополняется вставками
+constexpr std::size_t kSimdRun = 256;   // то же для int с SIMD-листом
+constexpr std::size_t kMinGallop = 7;   // столько побед подряд — переход в галоп
+constexpr std::size_t kSamples = 8;     // проб для оценки перемешанности серий
+constexpr std::size_t kSampleFrom = 1024;  // меньшие слияния считаются перемешанными
+
+// Первый элемент > x в [first, last): экспоненциальный поиск от начала
+template <class T, class Compare>
+const T* gallop_upper(const T* first, const T* last, const T& x, Compare comp) {
+    std::size_t n = last - first, hi = 1;
+    while (hi < n && !comp(x, first[hi])) hi *= 2;
+    return std::upper_bound(first + hi / 2, first + std::min(hi, n), x, comp);
+}
+
+// Первый элемент >= x в [first, last)
+template <class T, class Compare>
+const T* gallop_lower(const T* first, const T* last, const T& x, Compare comp) {
+    std::size_t n = last - first, hi = 1;
+    while (hi < n && comp(first[hi], x)) hi *= 2;
+    return std::lower_bound(first + hi / 2, first + std::min(hi, n), x, comp);
+}
+
+// Слияние a (копия левой серии) и b (правая серия на месте) в out, out <= b.
+// При равенстве раньше идёт a. Основной цикл без ветвлений, как merge_branchless;
+// после kMinGallop побед одной стороны подряд её полоса копируется блоком
+template <class T, class Compare>
+void gallop_merge(T* a, T* a_end, T* b, T* b_end, T* out, Compare comp) {
+    bool last = false;
+    std::size_t streak = 0;
+    while (a != a_end && b != b_end) {
+        bool take_b = comp(*b, *a);
+        *out++ = std::move(take_b ? *b : *a);
+        a += !take_b;
+        b += take_b;
+        streak = (take_b == last) ? streak + 1 : 1;
+        last = take_b;
+
+        if (streak >= kMinGallop && a != a_end && b != b_end) {
+            if (take_b) {
+                T* e = b + (gallop_lower<T>(b, b_end, *a, comp) - b);
+                out = std::move(b, e, out);
+                b = e;
+            } else {
+                T* e = a + (gallop_upper<T>(a, a_end, *b, comp) - a);
+                out = std::move(a, e, out);
+                a = e;
+            }
+            streak = 0;
+        }
+    }
+    std::move(a, a_end, out);  // хвост b уже на месте
+}
+
+// Серии [l, m) и [m, r) перемешаны: пробы из левой серии попадают в правую
+// в разные места. Для почти упорядоченных данных места совпадают (блоки)
+template <class T, class Compare>
+bool interleaved(const T* l, const T* m, const T* r, Compare comp) {
+    std::size_t nl = m - l, distinct = 0;
+    if (static_cast<std::size_t>(r - l) < kSampleFrom) return true;
+    const T* prev = nullptr;
+    for (std::size_t i = 1; i <= kSamples; i++) {
+        const T* pos = std::lower_bound(m, r, l[nl * i / (kSamples + 1)], comp);
+        distinct += pos != prev;
+        prev = pos;
+    }
+    return distinct * 4 >= kSamples * 3;
+}
+
+// Слияние соседних серий [l, m) и [m, r) через буфер tmp
+template <class T, class Compare>
+void merge_adjacent(T* a, std::size_t l, std::size_t m, std::size_t r, T* tmp, Compare comp) {
+    if (!comp(a[m], a[m - 1])) return;  // серии уже по порядку
+    if (comp(a[r - 1], a[l])) {          // вся правая строго меньше левой
+        std::rotate(a + l, a + m, a + r);
+        return;
+    }
+
+    // Начало левой серии до a[m] и конец правой от a[m - 1] уже на своих местах
+    l = gallop_upper(a + l, a + m, a[m], comp) - a;
+    r = gallop_lower(a + m, a + r, a[m - 1], comp) - a;
+
+    if constexpr (std::is_arithmetic<T>::value) {
+        // Дешёвое сравнение и перемешанные серии: галоп не окупается,
+        // быстрее merge_runs (SIMD для int) в tmp и копия обратно
+        if (interleaved(a + l, a + m, a + r, comp)) {
+            merge_runs(a + l, a + m, a + m, a + r, tmp, comp);
+            std::copy(tmp, tmp + (r - l), a + l);
+            return;
+        }
+    }
+    std::move(a + l, a + m, tmp);
+    gallop_merge(tmp, tmp + (m - l), a + m, a + r, a + l, comp);
+}
+
+// Конец серии, начинающейся в i; убывающая серия разворачивается,
+// короткая дополняется вставками до kMinRun
+template <class T, class Compare>
+std::size_t extend_run(T* a, T* tmp, std::size_t i, std::size_t n, Compare comp) {
+    std::size_t j = i + 1;
+    if (j == n) return n;
+
+    if (comp(a[j], a[i])) {
+        // Строго убывающая: разворот сохраняет устойчивость
+        while (j + 1 < n && comp(a[j + 1], a[j])) j++;
+        std::reverse(a + i, a + j + 1);
+    } else {
+        while (j + 1 < n && !comp(a[j + 1], a[j])) j++;
+    }
+    j++;
+
+    if (j - i < kMinRun && j < n) {
+        // int: короткая серия заменяется отсортированным SIMD-блоком
+        std::size_t simd_end = std::min(n, i + kSimdRun);
+        if (leaf_sort_simd(a + i, tmp, simd_end - i, false, comp))
+            return simd_end;
+
+        std::size_t end = std::min(n, i + kMinRun);
+        for (std::size_t k = j; k < end; k++) {
+            T x = std::move(a[k]);
+            // Двоичный поиск места в уже упорядоченном [i, k)
+            T* pos = std::upper_bound(a + i, a + k, x, comp);
+            std::move_backward(pos, a + k, a + k + 1);
+            *pos = std::move(x);
+        }
+        j = end;
+    }
+    return j;
+}
+
+// Мощность границы серий [s1, s1 + n1) и [s1 + n1, s1 + n1 + n2) в массиве длины n:
+// номер первого различающегося двоичного разряда середин серий (в долях n)
+inline int node_power(std::size_t n, std::size_t s1, std::size_t n1, std::size_t n2) {
+    std::uint64_t a = 2 * s1 + n1, b = 2 * s1 + 2 * n1 + n2, total = 2 * (std::uint64_t)n;
+    int power = 0;
+    for (;;) {
+        power++;
+        a *= 2;
+        b *= 2;
+        bool bit_a = a >= total, bit_b = b >= total;
+        if (bit_a != bit_b) return power;
+        if (bit_a) {
+            a -= total;
+            b -= total;
+        }
+    }
+}
+
+} // namespace natural_detail
+
+// Устойчивая адаптивная сортировка [a, a + n); tmp — буфер не меньше n
+template <class T, class Compare>
+void natural_sort(T* a, T* tmp, std::size_t n, Compare comp) {
+    using namespace natural_detail;
+    if (n <= 1) return;
+
+    struct run { std::size_t begin; int power; };
+    std::vector<run> stack;
+
+    std::size_t begin_a = 0, end_a = extend_run(a, tmp, 0, n, comp);
+    while (end_a < n) {
+        std::size_t begin_b = end_a, end_b = extend_run(a, tmp, begin_b, n, comp);
+        int power = node_power(n, begin_a, end_a - begin_a, end_b - begin_b);
+
+        while (!stack.empty() && stack.back().power > power) {
+            merge_adjacent(a, stack.back().begin, begin_a, end_a, tmp, comp);
+            begin_a = stack.back().begin;
+            stack.pop_back();
+        }
+        stack.push_back({begin_a, power});
+        begin_a = begin_b;
+        end_a = end_b;
+    }
+
+    while (!stack.empty()) {
+        merge_adjacent(a, stack.back().begin, begin_a, n, tmp, comp);
+        begin_a = stack.back().begin;
+        stack.pop_back();
+    }
+}
+
+} // namespace merge_lib
@@ -0,0 +1,252 @@
+#pragma once
+
+// NUMA-размещение данных и сортировка по узлам.
+//
+//   auto nodes = merge_lib::numa_nodes();
+//   merge_lib::numa_buffer<int> out(n), tmp(n);   // страницы ещё не тронуты
+//   auto stats = merge_lib::numa_sort<merge_lib::omp_backend>(src, out.data(), tmp.data(), n, nodes);
+//
+// Массив делится на части по узлам пропорционально числу ядер. Для каждого
+// узла свой поток, привязанный к ядрам узла: он первым касается своих частей
+// out и tmp (страницы попадают в память узла), сортирует часть бэкендом Local
+// на ядрах этого узла и потом пишет свой кусок итогового слияния. Между узлами
+// данные ходят только при k-way слиянии (один проход вместо log2(узлы)).
+//
+// Без libnuma узлы читаются из /sys/devices/system/node, привязка —
+// sched_setaffinity, размещение — first-touch. С -DMERGE_LIB_NUMA -lnuma
+// память частей дополнительно привязывается к узлу через numa_tonode_memory.
+// Потоки Local наследуют привязку потока узла (OpenMP, std::thread); рабочие
+// потоки TBB общие для процесса, поэтому для tbb_backend привязка не гарантируется.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#ifdef MERGE_LIB_NUMA
+#include <numa.h>
+#endif
+
+#include "merge_sort.hpp"
+#include "multiway_merge.hpp"
+
+namespace merge_lib {
+
+struct numa_node_info {
+    int id;
+    std::vector<int> cpus;
+};
+
+// Итоги по узлу: время этапов и пропускная способность памяти узла
+struct numa_stat {
+    int node;
+    int threads;
+    std::size_t elements;
+    double copy_sec, sort_sec, merge_sec;
+    double copy_gbs, merge_gbs;   // (чтение + запись) / время
+};
+
+namespace numa_detail {
+
+// Формат списков в sysfs: "0-3,8-11"
+inline std::vector<int> parse_cpulist(const std::string& s) {
+    std::vector<int> cpus;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        std::size_t dash = item.find('-');
+        int lo = std::stoi(item.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+        for (int c = lo; c <= hi; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+inline double seconds_since(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+}
+
+// Привязка памяти [p, p + bytes) к узлу; только целые страницы внутри диапазона
+inline void bind_memory(void* p, std::size_t bytes, int node) {
+#ifdef MERGE_LIB_NUMA
+    std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+    std::size_t lo = ((std::size_t)p + page - 1) / page * page;
+    std::size_t hi = ((std::size_t)p + bytes) / page * page;
+    if (hi > lo) numa_tonode_memory((void*)lo, hi - lo, node);
+#else
+    (void)p; (void)bytes; (void)node;
+#endif
+}
+
+inline std::vector<numa_stat> stats_with_bandwidth(std::vector<numa_stat> stats, std::size_t elem) {
+    for (auto& s : stats) {
+        double bytes = 2.0 * s.elements * elem / 1e9;
+        s.copy_gbs = s.copy_sec > 0 ? bytes / s.copy_sec : 0;
+        s.merge_gbs = s.merge_sec > 0 ? bytes / s.merge_sec : 0;
+    }
+    return stats;
+}
+
+} // namespace numa_detail
+
+// Узлы машины; если сведений нет — один узел со всеми ядрами
+inline std::vector<numa_node_info> numa_nodes() {
+    std::vector<numa_node_info> nodes;
+#ifdef MERGE_LIB_NUMA
+    if (numa_available() >= 0) {
+        struct bitmask* mask = numa_allocate_cpumask();
+        for (int id = 0; id <= numa_max_node(); id++) {
+            if (numa_node_to_cpus(id, mask) != 0) continue;
+            numa_node_info node{id, {}};
+            for (unsigned c = 0; c < mask->size; c++)
+                if (numa_bitmask_isbitset(mask, c)) node.cpus.push_back((int)c);
+            if (!node.cpus.empty()) nodes.push_back(node);
+        }
+        numa_free_cpumask(mask);
+    }
+#endif
+    if (nodes.empty()) {
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string ids;
+        if (online && std::getline(online, ids)) {
+            for (int id : numa_detail::parse_cpulist(ids)) {
+                std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+                std::string line;
+                if (!in || !std::getline(in, line)) continue;
+                numa_node_info node{id, numa_detail::parse_cpulist(line)};
+                if (!node.cpus.empty()) nodes.push_back(node);
+            }
+        }
+    }
+    if (nodes.empty()) {
+        numa_node_info node{0, {}};
+        for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); c++)
+            node.cpus.push_back((int)c);
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+// Привязать вызывающий поток к ядрам узла
+inline void pin_to_node(const numa_node_info& node) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : node.cpus) CPU_SET(c, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)node;
+#endif
+}
+
+// Буфер без инициализации: в отличие от std::vector<T>(n) главный поток
+// не заполняет его нулями, и страницы достаются тому, кто коснётся первым
+template <class T>
+class numa_buffer {
+public:
+    explicit numa_buffer(std::size_t n) : data_(new T[n]), size_(n) {}
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+    std::size_t size() const { return size_; }
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+
+private:
+    std::unique_ptr<T[]> data_;
+    std::size_t size_;
+};
+
+// Сортировка src[0, n) в dst через tmp (оба — свежие буферы, лучше numa_buffer).
+// Local — бэкенд внутри узла с полем threads (omp_backend, tbb_backend)
+template <class Local, class T, class Compare = std::less<T>>
+std::vector<numa_stat> numa_sort(const T* src, T* dst, T* tmp, std::size_t n,
+                                 const std::vector<numa_node_info>& nodes,
+                                 const Params& p = {}, Compare comp = {})
+{
+    using namespace numa_detail;
+    using clock = std::chrono::steady_clock;
+
+    std::size_t k = nodes.size();
+    std::size_t total_cpus = 0;
+    for (auto& node : nodes) total_cpus += node.cpus.size();
+
+    // Части пропорциональны числу ядер узла
+    std::vector<std::size_t> bounds(k + 1, 0);
+    std::size_t cpus_before = 0;
+    for (std::size_t i = 0; i < k; i++) {
+        cpus_before += nodes[i].cpus.size();
+        bounds[i + 1] = n * cpus_before / total_cpus;
+    }
+
+    std::vector<numa_stat> stats(k);
+    std::vector<run_ref<T>> runs(k);
+
+    auto on_nodes = [&](auto&& fn) {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < k; i++)
+            threads.emplace_back([&, i] {
+                pin_to_node(nodes[i]);
+                fn(i);
+            });
+        for (auto& t : threads) t.join();
+    };
+
+    // Этап 1: копия части в tmp (first-touch на узле) и сортировка там же, dst — буфер.
+    // Для одного узла слияние не нужно: сортируем сразу в dst
+    T* home = k == 1 ? dst : tmp;
+    T* scratch = k == 1 ? tmp : dst;
+    on_nodes([&](std::size_t i) {
+        std::size_t l = bounds[i], len = bounds[i + 1] - l;
+        bind_memory(tmp + l, len * sizeof(T), nodes[i].id);
+        bind_memory(dst + l, len * sizeof(T), nodes[i].id);
+
+        Local be;
+        be.threads = (int)nodes[i].cpus.size();
+        stats[i] = {nodes[i].id, be.threads, len, 0, 0, 0, 0, 0};
+
+        auto t = clock::now();
+        std::copy(src + l, src + l + len, home + l);
+        stats[i].copy_sec = seconds_since(t);
+
+        t = clock::now();
+        sort(home + l, home + l + len, scratch + l, be, p, comp);
+        stats[i].sort_sec = seconds_since(t);
+        runs[i] = {home + l, home + l + len};
+    });
+    if (k == 1) return stats_with_bandwidth(stats, sizeof(T));
+
+    // Этап 2: узел i пишет свой диапазон выхода dst[bounds[i], bounds[i+1]),
+    // границы во всех сериях находит multisequence_select
+    on_nodes([&](std::size_t i) {
+        auto lo = multisequence_select(runs, bounds[i], comp);
+        auto hi = multisequence_select(runs, bounds[i + 1], comp);
+        std::vector<run_ref<T>> slice;
+        for (std::size_t r = 0; r < k; r++)
+            if (lo[r] < hi[r]) slice.push_back({runs[r].first + lo[r], runs[r].first + hi[r]});
+
+        Local be;
+        be.threads = (int)nodes[i].cpus.size();
+        auto t = clock::now();
+        multiway_merge(be, slice, dst + bounds[i], comp);
+        stats[i].merge_sec = seconds_since(t);
+    });
+
+    return stats_with_bandwidth(stats, sizeof(T));
+}
+
+} // namespace merge_lib
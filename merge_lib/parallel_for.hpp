@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace merge_lib {
+
+// Параллельный цикл по [begin, end) поверх be.invoke (деление пополам)
+template <class Backend, class F>
+void parallel_for(Backend& be, std::size_t begin, std::size_t end, F&& fn) {
+    if (end - begin == 1) {
+        fn(begin);
+        return;
+    }
+    if (begin >= end) return;
+
+    std::size_t mid = begin + (end - begin) / 2;
+    be.invoke([&] { parallel_for(be, begin, mid, fn); },
+              [&] { parallel_for(be, mid, end, fn); });
+}
+
+} // namespace merge_lib
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "kernels.hpp"
+#include "params.hpp"
+#include "trace.hpp"
+
+namespace merge_lib {
+
+// Co-ranking (merge path): сколько элементов из a попадёт в первые k элементов
+// результата std::merge(a, b). При равенстве раньше идёт элемент из a.
+template <class T, class Compare>
+std::size_t co_rank(std::size_t k, const T* a, std::size_t na,
+                    const T* b, std::size_t nb, Compare comp)
+{
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = std::min(k, na);
+
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = k - i;
+        if (!comp(b[j - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+// Параллельное слияние: выход делится пополам, входы режутся в точке co_rank,
+// обе половины сливаются независимо через be.invoke
+template <class Backend, class T, class Compare>
+void parallel_merge(Backend& be, const T* a, std::size_t na, const T* b, std::size_t nb,
+                    T* out, int depth, const Params& p, Compare comp)
+{
+    std::size_t n = na + nb;
+    if (depth <= 0 || n < p.cutoff) {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::merge_part, depth, out, n);
+        merge_runs(a, a + na, b, b + nb, out, comp);
+        return;
+    }
+
+    std::size_t k = n / 2;
+    std::size_t i = co_rank(k, a, na, b, nb, comp);
+    std::size_t j = k - i;
+
+    be.invoke([&] { parallel_merge(be, a, i, b, j, out, depth - 1, p, comp); },
+              [&] { parallel_merge(be, a + i, na - i, b + j, nb - j, out + k, depth - 1, p, comp); });
+}
+
+// Параллельное копирование [src, src + n) в dst
+template <class Backend, class T>
+void parallel_copy(Backend& be, const T* src, std::size_t n, T* dst, int depth, const Params& p) {
+    if (depth <= 0 || n < p.cutoff) {
+        MERGE_LIB_TRACE_SCOPE(trace::phase::copy_part, depth, dst, n);
+        std::copy(src, src + n, dst);
+        return;
+    }
+
+    std::size_t m = n / 2;
+    be.invoke([&] { parallel_copy(be, src, m, dst, depth - 1, p); },
+              [&] { parallel_copy(be, src + m, n - m, dst + m, depth - 1, p); });
+}
+
+} // namespace merge_lib
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+namespace merge_lib {
+
+// Сортировка листьев дерева
+enum class leaf_kind {
+    insertion,  // вставками до leaf
+    simd,       // сортирующая сеть + векторные слияния до simd_leaf (только int, std::less)
+    natural     // адаптивная сортировка естественных серий (natural_sort.hpp) вместо рекурсии
+};
+
+// Параметры сортировки, общие для всех бэкендов
+struct Params {
+    std::size_t cutoff = 50000;  // ниже — последовательная сортировка
+    std::size_t leaf = 32;       // ниже — сортировка вставками
+    std::size_t simd_leaf = 16384;  // ниже — SIMD-сортировка листа (64 КиБ int, помещается в L2)
+    leaf_kind leaf_algo = leaf_kind::simd;
+    int max_depth = -1;          // -1: log2(потоки) + 2
+    bool ping_pong = true;       // false: merge в tmp + copy-back на каждом уровне
+    bool few_unique = true;      // проверять выборкой малое число различных ключей (few_unique.hpp)
+};
+
+// Глубина дерева задач без профиля (подбор под машину — tuning.hpp)
+inline int default_depth(int threads) {
+    if (threads <= 1) return 0;
+    return (int)std::log2(threads) + 2;
+}
+
+inline int resolve_depth(const Params& p, int threads) {
+    return p.max_depth >= 0 ? p.max_depth : default_depth(threads);
+}
+
+} // namespace merge_lib
@@ -0,0 +1,122 @@
+#pragma once
+
+// Параллельная LSD radix sort для целочисленных ключей (по 8 бит за проход).
+//
+//   merge_lib::omp_backend be;
+//   merge_lib::radix_sort(data, be);
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_for.hpp"
+
+namespace merge_lib {
+
+namespace radix_detail {
+
+constexpr int kBits = 8;
+constexpr std::size_t kBuckets = 1 << kBits;
+constexpr std::size_t kWriteCombine = 16;     // элементов в буфере на корзину
+constexpr std::size_t kMinBlock = 1 << 16;    // минимальный блок на поток
+
+// Ключ без знака: у знаковых типов инвертируется старший бит
+template <class T>
+auto key_bits(T x) {
+    using U = std::make_unsigned_t<T>;
+    U u = (U)x;
+    if (std::is_signed<T>::value)
+        u ^= U(1) << (sizeof(T) * 8 - 1);
+    return u;
+}
+
+template <class T>
+std::size_t digit(T x, int pass) {
+    return (key_bits(x) >> (pass * kBits)) & (kBuckets - 1);
+}
+
+} // namespace radix_detail
+
+// Сортировка [a, a + n) через буфер tmp того же размера
+template <class Backend, class T>
+void radix_sort(T* a, T* tmp, std::size_t n, Backend& be) {
+    static_assert(std::is_integral<T>::value, "radix_sort: нужен целочисленный тип");
+    using namespace radix_detail;
+
+    if (n <= 1) return;
+
+    std::size_t blocks = std::max<std::size_t>(1, std::min<std::size_t>(be.concurrency(), n / kMinBlock));
+    std::size_t block_size = (n + blocks - 1) / blocks;
+    std::vector<std::size_t> hist(blocks * kBuckets);
+
+    T* src = a;
+    T* dst = tmp;
+
+    be.run([&] {
+        for (int pass = 0; pass < (int)sizeof(T); pass++) {
+            // 1. Гистограммы по блокам
+            std::fill(hist.begin(), hist.end(), 0);
+            parallel_for(be, 0, blocks, [&](std::size_t b) {
+                std::size_t* h = &hist[b * kBuckets];
+                std::size_t l = b * block_size, r = std::min(n, l + block_size);
+                for (std::size_t i = l; i < r; i++)
+                    h[digit(src[i], pass)]++;
+            });
+
+            // Все ключи с одной цифрой — проход ничего не меняет
+            bool trivial = false;
+            for (std::size_t d = 0; d < kBuckets && !trivial; d++) {
+                std::size_t total = 0;
+                for (std::size_t b = 0; b < blocks; b++) total += hist[b * kBuckets + d];
+                trivial = (total == n);
+            }
+            if (trivial) continue;
+
+            // 2. Префиксные суммы: цифра старше блока (256 x blocks, дёшево)
+            std::size_t offset = 0;
+            for (std::size_t d = 0; d < kBuckets; d++) {
+                for (std::size_t b = 0; b < blocks; b++) {
+                    std::size_t c = hist[b * kBuckets + d];
+                    hist[b * kBuckets + d] = offset;
+                    offset += c;
+                }
+            }
+
+            // 3. Разброс через буферы write-combining (по кэш-линии на корзину)
+            parallel_for(be, 0, blocks, [&](std::size_t b) {
+                std::size_t* pos = &hist[b * kBuckets];
+                std::vector<T> buf(kBuckets * kWriteCombine);
+                std::size_t fill[kBuckets] = {};
+
+                std::size_t l = b * block_size, r = std::min(n, l + block_size);
+                for (std::size_t i = l; i < r; i++) {
+                    std::size_t d = digit(src[i], pass);
+                    T* slot = &buf[d * kWriteCombine];
+                    slot[fill[d]++] = src[i];
+                    if (fill[d] == kWriteCombine) {
+                        std::copy(slot, slot + kWriteCombine, dst + pos[d]);
+                        pos[d] += kWriteCombine;
+                        fill[d] = 0;
+                    }
+                }
+                for (std::size_t d = 0; d < kBuckets; d++)
+                    std::copy(&buf[d * kWriteCombine], &buf[d * kWriteCombine] + fill[d], dst + pos[d]);
+            });
+
+            std::swap(src, dst);
+        }
+    });
+
+    if (src != a)
+        std::copy(src, src + n, a);
+}
+
+template <class Backend, class T>
+void radix_sort(std::vector<T>& a, Backend& be) {
+    std::vector<T> tmp(a.size());
+    radix_sort(a.data(), tmp.data(), a.size(), be);
+}
+
+} // namespace merge_lib
@@ -0,0 +1,304 @@
+#pragma once
+
+// SIMD-ядра для int: сортирующая сеть в регистрах + векторное битоническое слияние.
+// AVX2 (блоки 8x8) и SSE4.1 (блоки 4x4), выбор по CPU во время выполнения.
+// На других архитектурах sort_leaf возвращает false и используется скалярный путь.
+
+#include <algorithm>
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MERGE_LIB_X86_SIMD 1
+#include <immintrin.h>
+#define MERGE_LIB_AVX2 __attribute__((target("avx2")))
+#define MERGE_LIB_SSE41 __attribute__((target("sse4.1")))
+#endif
+
+namespace merge_lib {
+namespace simd {
+
+enum class isa { scalar, sse41, avx2 };
+
+inline isa detect() {
+#ifdef MERGE_LIB_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return isa::avx2;
+    if (__builtin_cpu_supports("sse4.1")) return isa::sse41;
+#endif
+    return isa::scalar;
+}
+
+// Используемый набор инструкций (можно понизить для сравнения)
+inline isa& active_isa() {
+    static isa current = detect();
+    return current;
+}
+
+// Сортировка вставками хвоста, не кратного блоку
+inline void insertion_sort_int(int* a, std::size_t n) {
+    for (std::size_t i = 1; i < n; i++) {
+        int x = a[i];
+        std::size_t j = i;
+        for (; j > 0 && x < a[j - 1]; j--) a[j] = a[j - 1];
+        a[j] = x;
+    }
+}
+
+// Дослияние после векторного цикла: hi (w элементов) и короткий остаток одного
+// входа сливаются в маленький буфер, затем с длинным остатком другого
+inline void merge_tail(const int* hi, std::size_t w,
+                       const int* s, std::size_t ns, const int* l, std::size_t nl, int* out)
+{
+    int buf[16];
+    int* e = std::merge(hi, hi + w, s, s + ns, buf);
+    std::merge(buf, e, l, l + nl, out);
+}
+
+#ifdef MERGE_LIB_X86_SIMD
+
+namespace avx2 {
+
+MERGE_LIB_AVX2 inline void cmpswap(__m256i& a, __m256i& b) {
+    __m256i t = _mm256_min_epi32(a, b);
+    b = _mm256_max_epi32(a, b);
+    a = t;
+}
+
+// Оптимальная сеть на 8 входов (19 компараторов) по столбцам регистров
+MERGE_LIB_AVX2 inline void network(__m256i* r) {
+    cmpswap(r[0], r[2]); cmpswap(r[1], r[3]); cmpswap(r[4], r[6]); cmpswap(r[5], r[7]);
+    cmpswap(r[0], r[4]); cmpswap(r[1], r[5]); cmpswap(r[2], r[6]); cmpswap(r[3], r[7]);
+    cmpswap(r[0], r[1]); cmpswap(r[2], r[3]); cmpswap(r[4], r[5]); cmpswap(r[6], r[7]);
+    cmpswap(r[2], r[4]); cmpswap(r[3], r[5]);
+    cmpswap(r[1], r[4]); cmpswap(r[3], r[6]);
+    cmpswap(r[1], r[2]); cmpswap(r[3], r[4]); cmpswap(r[5], r[6]);
+}
+
+MERGE_LIB_AVX2 inline void transpose(__m256i* r) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]), t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]), t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    __m256i s0 = _mm256_unpacklo_epi64(t0, t2), s1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i s2 = _mm256_unpacklo_epi64(t1, t3), s3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i s4 = _mm256_unpacklo_epi64(t4, t6), s5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i s6 = _mm256_unpacklo_epi64(t5, t7), s7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(s0, s4, 0x20); r[4] = _mm256_permute2x128_si256(s0, s4, 0x31);
+    r[1] = _mm256_permute2x128_si256(s1, s5, 0x20); r[5] = _mm256_permute2x128_si256(s1, s5, 0x31);
+    r[2] = _mm256_permute2x128_si256(s2, s6, 0x20); r[6] = _mm256_permute2x128_si256(s2, s6, 0x31);
+    r[3] = _mm256_permute2x128_si256(s3, s7, 0x20); r[7] = _mm256_permute2x128_si256(s3, s7, 0x31);
+}
+
+// Битоническая последовательность в регистре -> отсортированная
+MERGE_LIB_AVX2 inline __m256i bitonic_clean(__m256i v) {
+    __m256i t = _mm256_permute2x128_si256(v, v, 1);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xF0);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xCC);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xAA);
+    return v;
+}
+
+// Два отсортированных регистра -> a: 8 меньших, b: 8 больших
+MERGE_LIB_AVX2 inline void merge_regs(__m256i& a, __m256i& b) {
+    b = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    __m256i lo = _mm256_min_epi32(a, b);
+    __m256i hi = _mm256_max_epi32(a, b);
+    a = bitonic_clean(lo);
+    b = bitonic_clean(hi);
+}
+
+MERGE_LIB_AVX2 inline void merge(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    if (na < 8 || nb < 8) {
+        std::merge(a, a + na, b, b + nb, out);
+        return;
+    }
+
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    std::size_t ia = 8, ib = 8;
+
+    while (true) {
+        merge_regs(va, vb);
+        _mm256_storeu_si256((__m256i*)out, va);
+        out += 8;
+
+        // Следующий блок берётся из входа с меньшим очередным элементом
+        bool take_a = ib >= nb || (ia < na && a[ia] <= b[ib]);
+        if (take_a) {
+            if (ia + 8 > na) break;
+            va = _mm256_loadu_si256((const __m256i*)(a + ia));
+            ia += 8;
+        } else {
+            if (ib + 8 > nb) break;
+            va = _mm256_loadu_si256((const __m256i*)(b + ib));
+            ib += 8;
+        }
+    }
+
+    alignas(32) int hi[8];
+    _mm256_store_si256((__m256i*)hi, vb);
+    if (na - ia < 8)
+        merge_tail(hi, 8, a + ia, na - ia, b + ib, nb - ib, out);
+    else
+        merge_tail(hi, 8, b + ib, nb - ib, a + ia, na - ia, out);
+}
+
+MERGE_LIB_AVX2 inline void sort_blocks(int* a, std::size_t full) {
+    for (std::size_t i = 0; i < full; i += 64) {
+        __m256i r[8];
+        for (int k = 0; k < 8; k++) r[k] = _mm256_loadu_si256((const __m256i*)(a + i + 8 * k));
+        network(r);
+        transpose(r);
+        for (int k = 0; k < 8; k++) _mm256_storeu_si256((__m256i*)(a + i + 8 * k), r[k]);
+    }
+}
+
+} // namespace avx2
+
+namespace sse41 {
+
+MERGE_LIB_SSE41 inline void cmpswap(__m128i& a, __m128i& b) {
+    __m128i t = _mm_min_epi32(a, b);
+    b = _mm_max_epi32(a, b);
+    a = t;
+}
+
+// Сеть на 4 входа (5 компараторов)
+MERGE_LIB_SSE41 inline void network(__m128i* r) {
+    cmpswap(r[0], r[1]); cmpswap(r[2], r[3]);
+    cmpswap(r[0], r[2]); cmpswap(r[1], r[3]);
+    cmpswap(r[1], r[2]);
+}
+
+MERGE_LIB_SSE41 inline void transpose(__m128i* r) {
+    __m128 r0 = _mm_castsi128_ps(r[0]), r1 = _mm_castsi128_ps(r[1]);
+    __m128 r2 = _mm_castsi128_ps(r[2]), r3 = _mm_castsi128_ps(r[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    r[0] = _mm_castps_si128(r0); r[1] = _mm_castps_si128(r1);
+    r[2] = _mm_castps_si128(r2); r[3] = _mm_castps_si128(r3);
+}
+
+MERGE_LIB_SSE41 inline __m128i bitonic_clean(__m128i v) {
+    __m128i t = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm_blend_epi16(_mm_min_epi32(v, t), _mm_max_epi32(v, t), 0xF0);
+    t = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_blend_epi16(_mm_min_epi32(v, t), _mm_max_epi32(v, t), 0xCC);
+    return v;
+}
+
+MERGE_LIB_SSE41 inline void merge_regs(__m128i& a, __m128i& b) {
+    b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3));
+    __m128i lo = _mm_min_epi32(a, b);
+    __m128i hi = _mm_max_epi32(a, b);
+    a = bitonic_clean(lo);
+    b = bitonic_clean(hi);
+}
+
+MERGE_LIB_SSE41 inline void merge(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    if (na < 4 || nb < 4) {
+        std::merge(a, a + na, b, b + nb, out);
+        return;
+    }
+
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    std::size_t ia = 4, ib = 4;
+
+    while (true) {
+        merge_regs(va, vb);
+        _mm_storeu_si128((__m128i*)out, va);
+        out += 4;
+
+        bool take_a = ib >= nb || (ia < na && a[ia] <= b[ib]);
+        if (take_a) {
+            if (ia + 4 > na) break;
+            va = _mm_loadu_si128((const __m128i*)(a + ia));
+            ia += 4;
+        } else {
+            if (ib + 4 > nb) break;
+            va = _mm_loadu_si128((const __m128i*)(b + ib));
+            ib += 4;
+        }
+    }
+
+    alignas(16) int hi[4];
+    _mm_store_si128((__m128i*)hi, vb);
+    if (na - ia < 4)
+        merge_tail(hi, 4, a + ia, na - ia, b + ib, nb - ib, out);
+    else
+        merge_tail(hi, 4, b + ib, nb - ib, a + ia, na - ia, out);
+}
+
+MERGE_LIB_SSE41 inline void sort_blocks(int* a, std::size_t full) {
+    for (std::size_t i = 0; i < full; i += 16) {
+        __m128i r[4];
+        for (int k = 0; k < 4; k++) r[k] = _mm_loadu_si128((const __m128i*)(a + i + 4 * k));
+        network(r);
+        transpose(r);
+        for (int k = 0; k < 4; k++) _mm_storeu_si128((__m128i*)(a + i + 4 * k), r[k]);
+    }
+}
+
+} // namespace sse41
+
+#endif // MERGE_LIB_X86_SIMD
+
+// Векторное слияние двух отсортированных массивов int; false — SIMD недоступен
+inline bool merge(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+#ifdef MERGE_LIB_X86_SIMD
+    switch (active_isa()) {
+    case isa::avx2: avx2::merge(a, na, b, nb, out); return true;
+    case isa::sse41: sse41::merge(a, na, b, nb, out); return true;
+    default: break;
+    }
+#endif
+    (void)a; (void)na; (void)b; (void)nb; (void)out;
+    return false;
+}
+
+// Сортировка листа [a, a + n): блоки w x w сортирующей сетью дают серии
+// длины w, дальше восходящие векторные слияния с чередованием a/tmp.
+// Результат в tmp, если to_tmp, иначе в a. false — SIMD недоступен.
+inline bool sort_leaf(int* a, int* tmp, std::size_t n, bool to_tmp) {
+    std::size_t w = 0;
+#ifdef MERGE_LIB_X86_SIMD
+    switch (active_isa()) {
+    case isa::avx2: w = 8; break;
+    case isa::sse41: w = 4; break;
+    default: break;
+    }
+#endif
+    if (w == 0) return false;
+
+    std::size_t full = n - n % (w * w);
+#ifdef MERGE_LIB_X86_SIMD
+    if (w == 8)
+        avx2::sort_blocks(a, full);
+    else
+        sse41::sort_blocks(a, full);
+#endif
+    insertion_sort_int(a + full, n - full);
+
+    int* src = a;
+    int* dst = tmp;
+    for (std::size_t width = w; width < n; width *= 2) {
+        for (std::size_t i = 0; i < n; i += 2 * width) {
+            std::size_t m = std::min(i + width, n);
+            std::size_t r = std::min(i + 2 * width, n);
+            merge(src + i, m - i, src + m, r - m, dst + i);
+        }
+        std::swap(src, dst);
+    }
+
+    int* want = to_tmp ? tmp : a;
+    if (src != want)
+        std::copy(src, src + n, want);
+    return true;
+}
+
+} // namespace simd
+} // namespace merge_lib
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace merge_lib {
+
+// Пул потоков фиксированного размера, живёт между вызовами сортировки.
+// Рабочие берут самые старые (крупные) задачи, ожидающий поток помогает
+// с самыми новыми — так вложенный fork-join не блокирует пул.
+class thread_pool {
+public:
+    explicit thread_pool(int workers) {
+        for (int i = 0; i < workers; i++)
+            workers_.emplace_back([this] { worker_loop(); });
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Общий пул процесса: hardware_concurrency - 1 рабочих + вызывающий поток
+    static thread_pool& global() {
+        static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    // Выполнить одну задачу из очереди в текущем потоке
+    bool try_run_one() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) return false;
+            task = std::move(tasks_.back());
+            tasks_.pop_back();
+        }
+        task();
+        return true;
+    }
+
+    int size() const { return (int)workers_.size(); }
+
+private:
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
+
+} // namespace merge_lib
@@ -0,0 +1,309 @@
+#pragma once
+
+// Трассировка дерева задач: начало и конец каждой задачи, глубина, размер
+// диапазона и фаза (сортировка, лист, слияние, копирование).
+//
+//   g++ -DMERGE_LIB_TRACE ...
+//
+//   merge_lib::trace::start();
+//   merge_lib::sort(data, be);
+//   merge_lib::trace::stop();
+//   merge_lib::trace::write_chrome("trace.json");   // chrome://tracing, ui.perfetto.dev
+//   merge_lib::trace::print_summary(std::cout);     // критический путь, простой потоков
+//
+// У каждого потока свой кольцевой буфер событий: запись — одна relaxed-загрузка
+// флага и запись в свой буфер без блокировок и атомарных RMW. При переполнении
+// старые события затираются. Без MERGE_LIB_TRACE макрос MERGE_LIB_TRACE_SCOPE
+// пустой, а функции ниже ничего не делают.
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifdef MERGE_LIB_TRACE
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+#endif
+
+namespace merge_lib {
+namespace trace {
+
+enum class phase : std::uint8_t {
+    sort,        // узел дерева: обе половины + слияние
+    leaf,        // последовательная сортировка листа
+    merge,       // слияние узла (вызов parallel_merge целиком)
+    copy,        // copy-back узла
+    merge_part,  // последовательный кусок parallel_merge
+    copy_part    // последовательный кусок parallel_copy
+};
+
+inline const char* name(phase ph) {
+    static const char* names[] = {"sort", "leaf", "merge", "copy", "merge_part", "copy_part"};
+    return names[(int)ph];
+}
+
+#ifdef MERGE_LIB_TRACE
+
+constexpr bool compiled = true;
+constexpr std::size_t kRingSize = 1 << 16;   // событий на поток
+
+struct event {
+    std::int64_t begin_ns, end_ns;
+    std::uintptr_t addr;    // начало диапазона: вместе с n и depth — ключ узла
+    std::size_t n;
+    int depth;              // оставшаяся глубина, как в sort_task
+    std::uint32_t elem;     // sizeof(T): шаг адреса между половинами
+    phase ph;
+};
+
+namespace detail {
+
+struct ring {
+    int tid;
+    std::vector<event> slots = std::vector<event>(kRingSize);
+    std::atomic<std::size_t> head{0};
+};
+
+struct registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ring>> rings;
+    std::atomic<bool> enabled{false};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+inline registry& global() {
+    static registry r;
+    return r;
+}
+
+// Буфер потока регистрируется один раз, дальше запись без блокировок
+inline ring& local_ring() {
+    thread_local ring* r = [] {
+        registry& g = global();
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.rings.push_back(std::make_unique<ring>());
+        g.rings.back()->tid = (int)g.rings.size() - 1;
+        return g.rings.back().get();
+    }();
+    return *r;
+}
+
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - global().epoch).count();
+}
+
+// Один писатель на буфер: слот, затем head с release
+inline void push(const event& e) {
+    ring& r = local_ring();
+    std::size_t h = r.head.load(std::memory_order_relaxed);
+    r.slots[h % kRingSize] = e;
+    r.head.store(h + 1, std::memory_order_release);
+}
+
+struct traced_event {
+    event e;
+    int tid;
+};
+
+inline std::vector<traced_event> collect(std::size_t* lost = nullptr) {
+    registry& g = global();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    std::vector<traced_event> out;
+    if (lost) *lost = 0;
+    for (auto& r : g.rings) {
+        std::size_t h = r->head.load(std::memory_order_acquire);
+        std::size_t first = h > kRingSize ? h - kRingSize : 0;
+        if (lost) *lost += first;
+        for (std::size_t i = first; i < h; i++) out.push_back({r->slots[i % kRingSize], r->tid});
+    }
+    std::sort(out.begin(), out.end(),
+              [](const traced_event& x, const traced_event& y) { return x.e.begin_ns < y.e.begin_ns; });
+    return out;
+}
+
+} // namespace detail
+
+// Область задачи: событие пишется при выходе
+class scope {
+public:
+    template <class T>
+    scope(phase ph, int depth, const T* addr, std::size_t n) {
+        if (!detail::global().enabled.load(std::memory_order_relaxed)) return;
+        active_ = true;
+        e_ = {detail::now_ns(), 0, (std::uintptr_t)addr, n, depth, (std::uint32_t)sizeof(T), ph};
+    }
+
+    ~scope() {
+        if (!active_) return;
+        e_.end_ns = detail::now_ns();
+        detail::push(e_);
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    bool active_ = false;
+    event e_{};
+};
+
+// Очистить буферы и начать запись
+inline void start() {
+    detail::registry& g = detail::global();
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        for (auto& r : g.rings) r->head.store(0, std::memory_order_relaxed);
+    }
+    g.epoch = std::chrono::steady_clock::now();
+    g.enabled.store(true, std::memory_order_release);
+}
+
+inline void stop() {
+    detail::global().enabled.store(false, std::memory_order_release);
+}
+
+// Chrome trace JSON: полные события "X", поток — tid, время в мкс
+inline bool write_chrome(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    auto events = detail::collect();
+    out << "{\"traceEvents\": [\n";
+    for (std::size_t i = 0; i < events.size(); i++) {
+        const event& e = events[i].e;
+        out << "  {\"name\": \"" << name(e.ph) << "\", \"cat\": \"merge_lib\", \"ph\": \"X\", \"pid\": 0"
+            << ", \"tid\": " << events[i].tid << ", \"ts\": " << e.begin_ns / 1e3
+            << ", \"dur\": " << (e.end_ns - e.begin_ns) / 1e3
+            << ", \"args\": {\"depth\": " << e.depth << ", \"n\": " << e.n << "}}"
+            << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    out << "], \"displayTimeUnit\": \"ms\"}\n";
+    return true;
+}
+
+// Критический путь дерева: для листа — его время, для узла — максимум
+// по половинам плюс слияние и copy-back узла. Простой потока — время
+// трассы минус его листья и последовательные куски слияний/копирования
+inline void print_summary(std::ostream& os) {
+    std::size_t lost = 0;
+    auto events = detail::collect(&lost);
+    if (events.empty()) {
+        os << "Трасса пуста\n";
+        return;
+    }
+
+    using key = std::tuple<std::uintptr_t, std::size_t, int>;
+    std::map<key, const event*> leaf, merge, copy;
+    const event* root = nullptr;
+    std::int64_t t0 = events.front().e.begin_ns, t1 = 0;
+    std::map<int, std::int64_t> busy;
+    std::set<int> root_merge_threads;
+
+    for (auto& te : events) {
+        const event& e = te.e;
+        t1 = std::max(t1, e.end_ns);
+        key k{e.addr, e.n, e.depth};
+        switch (e.ph) {
+        case phase::sort:
+            if (!root || e.n > root->n) root = &e;
+            break;
+        case phase::leaf:
+            leaf[k] = &e;
+            if (!root || e.n > root->n) root = &e;
+            break;
+        case phase::merge: merge[k] = &e; break;
+        case phase::copy: copy[k] = &e; break;
+        default: break;
+        }
+        if (e.ph == phase::leaf || e.ph == phase::merge_part || e.ph == phase::copy_part)
+            busy[te.tid] += e.end_ns - e.begin_ns;
+    }
+    auto dur = [](const event* e) { return e ? (e->end_ns - e->begin_ns) / 1e9 : 0.0; };
+    auto find = [](const std::map<key, const event*>& m, std::uintptr_t a, std::size_t n, int d) {
+        auto it = m.find(key{a, n, d});
+        return it == m.end() ? nullptr : it->second;
+    };
+
+    // Критический путь с разбивкой по уровням
+    struct step { int level; std::size_t n; double merge, copy, leaf; };
+    std::size_t elem = root->elem;
+    std::function<std::pair<double, std::vector<step>>(std::uintptr_t, std::size_t, int, int)> cp =
+        [&](std::uintptr_t a, std::size_t n, int d, int level) -> std::pair<double, std::vector<step>> {
+            if (const event* l = find(leaf, a, n, d)) return {dur(l), {{level, n, 0, 0, dur(l)}}};
+            if (d <= 0 || n < 2) return {0.0, {}};
+            std::size_t m = n / 2;
+            auto left = cp(a, m, d - 1, level + 1);
+            auto right = cp(a + m * elem, n - m, d - 1, level + 1);
+            auto best = left.first >= right.first ? left : right;
+            double mg = dur(find(merge, a, n, d)), cb = dur(find(copy, a, n, d));
+            best.second.insert(best.second.begin(), step{level, n, mg, cb, 0});
+            best.first += mg + cb;
+            return best;
+        };
+    auto path = cp(root->addr, root->n, root->depth, 0);
+
+    double wall = (t1 - t0) / 1e9;
+    double work = 0;
+    for (auto& b : busy) work += b.second / 1e9;
+
+    const event* root_merge = find(merge, root->addr, root->n, root->depth);
+    if (root_merge)
+        for (auto& te : events)
+            if (te.e.ph == phase::merge_part && te.e.begin_ns >= root_merge->begin_ns
+                && te.e.end_ns <= root_merge->end_ns)
+                root_merge_threads.insert(te.tid);
+
+    os << "Трасса: " << events.size() << " событий, потоков " << busy.size()
+       << ", время " << wall << " s";
+    if (lost) os << " (потеряно " << lost << " событий)";
+    os << "\n";
+    os << "Работа (листья + куски слияний и копий): " << work << " s, параллелизм "
+       << (path.first > 0 ? work / path.first : 0) << "\n";
+    os << "Критический путь: " << path.first << " s (" << 100 * path.first / wall << "% времени)\n";
+    for (auto& s : path.second) {
+        os << "  уровень " << s.level << ", n = " << s.n << ": ";
+        if (s.leaf > 0) os << "лист " << s.leaf << " s\n";
+        else {
+            os << "слияние " << s.merge << " s";
+            if (s.copy > 0) os << ", copy-back " << s.copy << " s";
+            os << "\n";
+        }
+    }
+    if (root_merge)
+        os << "Корневое слияние: " << dur(root_merge) << " s (" << 100 * dur(root_merge) / wall
+           << "% времени), потоков " << root_merge_threads.size() << "\n";
+    os << "Простой потоков:";
+    for (auto& b : busy) os << " t" << b.first << " " << (int)(100 * (1 - b.second / 1e9 / wall)) << "%";
+    os << "\n";
+}
+
+#define MERGE_LIB_TRACE_CAT2(a, b) a##b
+#define MERGE_LIB_TRACE_CAT(a, b) MERGE_LIB_TRACE_CAT2(a, b)
+#define MERGE_LIB_TRACE_SCOPE(ph, depth, addr, n) \
+    ::merge_lib::trace::scope MERGE_LIB_TRACE_CAT(trace_scope_, __LINE__)(ph, depth, addr, n)
+
+#else
+
+constexpr bool compiled = false;
+
+inline void start() {}
+inline void stop() {}
+inline bool write_chrome(const std::string&) { return false; }
+inline void print_summary(std::ostream& os) { os << "Трассировка не собрана (нужен -DMERGE_LIB_TRACE)\n"; }
+
+#define MERGE_LIB_TRACE_SCOPE(ph, depth, addr, n) ((void)0)
+
+#endif
+
+} // namespace trace
+} // namespace merge_lib
@@ -0,0 +1,271 @@
+#pragma once
+
+// Подбор параметров под машину, бэкенд, тип ключа и число потоков.
+//
+//   ./tune --engines omp,thread --threads 1,2,4 --keys 32,64     (bench/tune.cpp)
+//
+// пишет строки в файл профиля (MERGE_LIB_PROFILE или ./merge_lib.profile),
+// программы читают их при запуске:
+//
+//   merge_lib::Params params = merge_lib::tuned_params<int>("omp", be.concurrency());
+//
+// Запись профиля — процессор (model name из /proc/cpuinfo), бэкенд, тип, потоки
+// и найденные cutoff, max_depth, leaf_algo. Так на каждой модели сервера свои
+// значения, а на незнакомой машине остаются значения Params по умолчанию.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "params.hpp"
+
+namespace merge_lib {
+
+inline const char* to_string(leaf_kind kind) {
+    switch (kind) {
+    case leaf_kind::insertion: return "insertion";
+    case leaf_kind::simd: return "simd";
+    case leaf_kind::natural: return "natural";
+    }
+    return "?";
+}
+
+inline bool parse_leaf_kind(const std::string& s, leaf_kind& kind) {
+    for (leaf_kind k : {leaf_kind::insertion, leaf_kind::simd, leaf_kind::natural})
+        if (s == to_string(k)) {
+            kind = k;
+            return true;
+        }
+    return false;
+}
+
+// Имя типа ключа в профиле: int32, uint64, float64, ...
+template <class T>
+std::string type_name() {
+    if (std::is_floating_point<T>::value) return "float" + std::to_string(sizeof(T) * 8);
+    if (std::is_integral<T>::value)
+        return (std::is_signed<T>::value ? "int" : "uint") + std::to_string(sizeof(T) * 8);
+    return "bytes" + std::to_string(sizeof(T));
+}
+
+// Модель процессора — ключ профиля вместо имени хоста
+inline std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) != 0) continue;
+        std::size_t colon = line.find(':');
+        if (colon == std::string::npos) break;
+        std::string model = line.substr(colon + 1);
+        model.erase(0, model.find_first_not_of(" \t"));
+        std::replace(model.begin(), model.end(), '\t', ' ');
+        return model;
+    }
+    return "unknown";
+}
+
+inline std::string profile_path() {
+    const char* env = std::getenv("MERGE_LIB_PROFILE");
+    return env && *env ? env : "merge_lib.profile";
+}
+
+// ---- Файл профиля ----
+
+// Строка файла, поля через табуляцию:
+// cpu  backend  type  threads  cutoff  max_depth  leaf_algo  seconds  n
+struct profile_entry {
+    std::string cpu, backend, type;
+    int threads = 1;
+    std::size_t cutoff = 0;
+    int max_depth = -1;
+    leaf_kind leaf_algo = leaf_kind::simd;
+    double seconds = 0;   // время на тестовом входе, для справки
+    std::size_t n = 0;
+
+    bool same_key(const profile_entry& o) const {
+        return cpu == o.cpu && backend == o.backend && type == o.type && threads == o.threads;
+    }
+};
+
+// Допустимые значения записи: cutoff >= 2 (узел из одного элемента не делится),
+// глубина -1 (по умолчанию) .. kMaxDepth. Запись с другими значениями
+// пропускается, и остаются значения Params по умолчанию
+constexpr std::size_t kMinCutoff = 2;
+constexpr int kMaxDepth = 24;
+
+inline bool valid_entry(const profile_entry& e) {
+    return e.threads >= 1 && e.cutoff >= kMinCutoff && e.max_depth >= -1 && e.max_depth <= kMaxDepth;
+}
+
+inline bool parse_entry(const std::string& line, profile_entry& e) {
+    if (line.empty() || line[0] == '#') return false;
+    std::vector<std::string> f;
+    std::stringstream ss(line);
+    std::string item;
+    while (std::getline(ss, item, '\t')) f.push_back(item);
+    if (f.size() < 7) return false;
+    e.cpu = f[0];
+    e.backend = f[1];
+    e.type = f[2];
+    e.threads = std::atoi(f[3].c_str());
+    e.cutoff = std::strtoull(f[4].c_str(), nullptr, 10);
+    e.max_depth = std::atoi(f[5].c_str());
+    if (!parse_leaf_kind(f[6], e.leaf_algo)) return false;
+    e.seconds = f.size() > 7 ? std::atof(f[7].c_str()) : 0;
+    e.n = f.size() > 8 ? std::strtoull(f[8].c_str(), nullptr, 10) : 0;
+    return valid_entry(e);
+}
+
+inline std::vector<profile_entry> load_profile(const std::string& path = profile_path()) {
+    std::vector<profile_entry> entries;
+    std::ifstream in(path);
+    std::string line;
+    profile_entry e;
+    while (std::getline(in, line))
+        if (parse_entry(line, e)) entries.push_back(e);
+    return entries;
+}
+
+// Добавить или заменить запись с тем же ключом
+inline bool save_profile(const profile_entry& entry, const std::string& path = profile_path()) {
+    auto entries = load_profile(path);
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&](const profile_entry& e) { return e.same_key(entry); });
+    if (it != entries.end()) *it = entry;
+    else entries.push_back(entry);
+
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# cpu\tbackend\ttype\tthreads\tcutoff\tmax_depth\tleaf_algo\tseconds\tn\n";
+    for (auto& e : entries)
+        out << e.cpu << '\t' << e.backend << '\t' << e.type << '\t' << e.threads << '\t'
+            << e.cutoff << '\t' << e.max_depth << '\t' << to_string(e.leaf_algo) << '\t'
+            << e.seconds << '\t' << e.n << '\n';
+    return (bool)out;
+}
+
+// Запись для этой машины, бэкенда и типа с ближайшим числом потоков
+inline bool find_profile(const std::string& backend, const std::string& type, int threads,
+                         profile_entry& found, const std::string& path = profile_path())
+{
+    std::string cpu = cpu_model();
+    bool any = false;
+    for (auto& e : load_profile(path)) {
+        if (e.cpu != cpu || e.backend != backend || e.type != type) continue;
+        if (!any || std::abs(e.threads - threads) < std::abs(found.threads - threads)) {
+            found = e;
+            any = true;
+        }
+    }
+    return any;
+}
+
+// Params из профиля поверх base; без записи — base без изменений.
+// Глубина подбиралась для e.threads потоков: при другом числе она сдвигается
+// на разницу log2, а запись для одного потока (или с -1) глубину не задаёт
+template <class T>
+Params tuned_params(const std::string& backend, int threads, Params base = {},
+                    const std::string& path = profile_path())
+{
+    profile_entry e;
+    if (!find_profile(backend, type_name<T>(), threads, e, path)) return base;
+    base.cutoff = e.cutoff;
+    base.leaf_algo = e.leaf_algo;
+    if (threads <= 1)
+        base.max_depth = 0;
+    else if (e.threads == threads)
+        base.max_depth = e.max_depth;
+    else if (e.threads > 1 && e.max_depth >= 0) {
+        int shift = (int)std::lround(std::log2((double)threads / e.threads));
+        base.max_depth = std::min(kMaxDepth, std::max(1, e.max_depth + shift));
+    }
+    return base;
+}
+
+// ---- Подбор ----
+
+struct tune_result {
+    Params params;
+    double seconds = 0;
+    int measured = 0;   // число замеренных конфигураций
+};
+
+// Покоординатный спуск: лист -> глубина -> cutoff -> глубина ещё раз.
+// Каждая конфигурация — минимум из reps сортировок случайных n ключей
+// (без few_unique: подбирается дерево слияний)
+template <class T, class Backend>
+tune_result tune(Backend& be, std::size_t n, int reps = 3, std::ostream* log = nullptr) {
+    static_assert(std::is_arithmetic<T>::value, "tune: ключи — числа");
+    std::mt19937_64 gen(42);
+    std::vector<T> src(n), a(n), tmp(n);
+    for (auto& x : src) {
+        if (std::is_integral<T>::value) x = (T)gen();
+        else x = (T)std::uniform_real_distribution<double>(-1e9, 1e9)(gen);
+    }
+
+    tune_result best;
+    best.params.few_unique = false;
+
+    auto measure = [&](const Params& p) {
+        double t = 1e30;
+        for (int r = 0; r < reps; r++) {
+            std::copy(src.begin(), src.end(), a.begin());
+            auto t0 = std::chrono::steady_clock::now();
+            sort(a.data(), a.data() + n, tmp.data(), be, p);
+            t = std::min(t, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        }
+        best.measured++;
+        if (log)
+            *log << "  cutoff " << p.cutoff << ", depth " << resolve_depth(p, be.concurrency())
+                 << ", leaf " << to_string(p.leaf_algo) << ": " << t << " s\n";
+        return t;
+    };
+
+    auto try_all = [&](auto&& apply, const auto& candidates) {
+        for (const auto& c : candidates) {
+            Params p = best.params;
+            apply(p, c);
+            double t = measure(p);
+            if (t < best.seconds) {
+                best.seconds = t;
+                best.params = p;
+            }
+        }
+    };
+
+    int threads = be.concurrency();
+    best.params.max_depth = default_depth(threads);
+    best.seconds = measure(best.params);
+
+    std::vector<int> depths;
+    int d0 = threads > 1 ? (int)std::ceil(std::log2(threads)) : 0;
+    for (int d = d0; d <= d0 + 4 && (threads > 1 || d == 0); d++) depths.push_back(d);
+
+    std::vector<std::size_t> cutoffs;
+    for (std::size_t c = 1 << 12; c <= (1 << 20) && c <= n / 2; c *= 2) cutoffs.push_back(c);
+
+    auto set_leaf = [](Params& p, leaf_kind k) { p.leaf_algo = k; };
+    auto set_depth = [](Params& p, int d) { p.max_depth = d; };
+    auto set_cutoff = [](Params& p, std::size_t c) { p.cutoff = c; };
+
+    try_all(set_leaf, std::vector<leaf_kind>{leaf_kind::simd, leaf_kind::insertion, leaf_kind::natural});
+    if (threads > 1) {
+        try_all(set_depth, depths);
+        try_all(set_cutoff, cutoffs);
+        try_all(set_depth, depths);
+    }
+    best.params.few_unique = true;
+    return best;
+}
+
+} // namespace merge_lib
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace merge_lib {
+
+// Задача планировщика: живёт на стеке породившего потока до завершения
+struct ws_task {
+    void (*fn)(void*) = nullptr;
+    void* arg = nullptr;
+    std::atomic<bool> done{false};
+
+    void execute() {
+        fn(arg);
+        done.store(true, std::memory_order_release);
+    }
+};
+
+// Дек Chase–Lev: владелец кладёт и забирает снизу, воры крадут сверху
+class ws_deque {
+public:
+    explicit ws_deque(std::int64_t capacity = 64)
+        : array_(new ring(capacity)) { retired_.emplace_back(array_.load()); }
+
+    void push(ws_task* x) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        ring* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+            a = grow(a, t, b);
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    ws_task* pop() {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        ring* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        ws_task* x = a->get(b);
+        if (t == b) {
+            // последний элемент: соревнуемся с ворами
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                x = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    ws_task* steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        ring* a = array_.load(std::memory_order_acquire);
+        ws_task* x = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return nullptr;
+        return x;
+    }
+
+private:
+    struct ring {
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<ws_task*>[]> slots;
+
+        explicit ring(std::int64_t c) : capacity(c), slots(new std::atomic<ws_task*>[c]) {}
+        ws_task* get(std::int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, ws_task* x) { slots[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+    };
+
+    // Старые кольца не освобождаются до конца жизни дека: вор может их ещё читать
+    ring* grow(ring* a, std::int64_t t, std::int64_t b) {
+        ring* bigger = new ring(a->capacity * 2);
+        for (std::int64_t i = t; i < b; i++) bigger->put(i, a->get(i));
+        retired_.emplace_back(bigger);
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<ring*> array_;
+    std::vector<std::unique_ptr<ring>> retired_;
+};
+
+// Планировщик с кражей работы: у каждого потока свой дек. Слот 0 принадлежит
+// потоку, вызвавшему run(), остальные — рабочим потокам пула.
+class work_stealing_pool {
+public:
+    explicit work_stealing_pool(int threads) : deques_(std::max(1, threads)) {
+        for (int i = 1; i < (int)deques_.size(); i++)
+            workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    ~work_stealing_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    static work_stealing_pool& global() {
+        static work_stealing_pool pool((int)std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    // Выполнить f в текущем потоке как участнике пула
+    template <class F>
+    void run(F&& f) {
+        if (current_pool() == this) {
+            f();
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_.store(true);
+        }
+        cv_.notify_all();
+
+        bind(0);
+        f();
+        bind(-1);
+
+        active_.store(false);
+    }
+
+    // Положить задачу в дек текущего потока (вызывать только внутри run())
+    void spawn(ws_task* t) { deques_[current_index()].push(t); }
+
+    // Ждать завершения задачи, выполняя свою и чужую работу
+    void wait(ws_task* t) {
+        int self = current_index();
+        std::minstd_rand rng(self + 1);
+        while (!t->done.load(std::memory_order_acquire)) {
+            ws_task* x = deques_[self].pop();
+            if (!x) x = steal(self, rng);
+            if (x)
+                x->execute();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // true, если текущий поток участвует в этом пуле
+    bool inside() const { return current_pool() == this; }
+
+    int size() const { return (int)deques_.size(); }
+
+private:
+    static work_stealing_pool*& current_pool() {
+        thread_local work_stealing_pool* pool = nullptr;
+        return pool;
+    }
+
+    static int& current_index() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    void bind(int index) {
+        current_pool() = index >= 0 ? this : nullptr;
+        current_index() = index;
+    }
+
+    ws_task* steal(int self, std::minstd_rand& rng) {
+        int n = (int)deques_.size();
+        if (n <= 1) return nullptr;
+        int start = rng() % n;
+        for (int k = 0; k < n; k++) {
+            int victim = (start + k) % n;
+            if (victim == self) continue;
+            if (ws_task* x = deques_[victim].steal()) return x;
+        }
+        return nullptr;
+    }
+
+    void worker_loop(int index) {
+        bind(index);
+        std::minstd_rand rng(index + 1);
+        while (true) {
+            // вне run() рабочие спят, внутри — крутятся в поиске работы
+            if (!active_.load()) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || active_.load(); });
+                if (stop_) return;
+            }
+
+            ws_task* x = deques_[index].pop();
+            if (!x) x = steal(index, rng);
+            if (x)
+                x->execute();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    std::vector<ws_deque> deques_;
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> active_{false};
+    bool stop_ = false;
+};
+
+} // namespace merge_lib
@@ -0,0 +1,90 @@
+#include <mpi.h>
+#include <omp.h>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/backend_omp.hpp"
+#include "../merge_lib/backend_tbb.hpp"
+#include "../merge_lib/backend_mpi.hpp"
+
+// Гибрид MPI + потоки: каждый ранг сортирует и сливает свою часть OpenMP или TBB.
+//   mpirun -np P --map-by ppr:R:node ./merge_hybrid [omp|tbb] [потоков_на_ранг]
+// Для сравнения в том же запуске меряется чистый MPI (один поток на ранг).
+
+template <class Local>
+double run(std::vector<int>& data, Local local, merge_lib::mpi_mode mode) {
+    merge_lib::mpi_backend<Local> be;
+    be.local = local;
+    be.mode = mode;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    merge_lib::sort(data, be);
+    return MPI_Wtime() - t0;
+}
+
+int main(int argc, char** argv) {
+    merge_lib::init_thread(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    std::string engine = argc > 1 ? argv[1] : "omp";
+    int threads_arg = argc > 2 ? std::atoi(argv[2]) : 0;
+    const std::size_t N = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2'000'000;
+    merge_lib::node_layout layout = merge_lib::detect_layout(MPI_COMM_WORLD, threads_arg);
+
+    std::vector<int> data, data_std;
+    double t_std = 0.0;
+    if (rank == 0) {
+        data.resize(N);
+        for (std::size_t i = 0; i < N; ++i) data[i] = rand() % N;
+
+        data_std = data;
+        double t_start_std = MPI_Wtime();
+        std::sort(data_std.begin(), data_std.end());
+        t_std = MPI_Wtime() - t_start_std;
+    }
+
+    auto mode = merge_lib::mpi_mode::sample_sort;
+
+    // Чистый MPI
+    std::vector<int> data_mpi = data;
+    double t_mpi = run(data_mpi, merge_lib::serial_backend{}, mode);
+
+    // Гибрид
+    std::vector<int> data_hybrid = data;
+    double t_hybrid;
+    if (engine == "tbb") {
+        merge_lib::tbb_backend local;
+        local.threads = layout.threads_per_rank;
+        t_hybrid = run(data_hybrid, local, mode);
+    } else {
+        merge_lib::omp_backend local;
+        local.threads = layout.threads_per_rank;
+        t_hybrid = run(data_hybrid, local, mode);
+    }
+
+    if (rank == 0) {
+        std::cout << "\n=== РЕЗУЛЬТАТЫ (MPI + " << engine << ") ===\n";
+        std::cout << "Размер массива:   " << N << "\n";
+        std::cout << "MPI процессов:    " << size << "\n";
+        std::cout << "Рангов на узел:   " << layout.ranks_per_node << "\n";
+        std::cout << "Потоков на ранг:  " << layout.threads_per_rank << "\n";
+        std::cout << "std::sort:        " << t_std << " сек\n";
+        std::cout << "Чистый MPI:       " << t_mpi << " сек\n";
+        std::cout << "Гибрид:           " << t_hybrid << " сек\n\n";
+
+        bool ok = (data_mpi == data_std) && (data_hybrid == data_std);
+        std::cout << (ok ? "Результат совпадает с std::sort\n"
+                         : "Ошибка в результате сортировки\n");
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -6,6 +6,11 @@
 #include <numeric>
 #include <cstdlib>
 #include <cmath> 
+#include <string>
+
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/mpi_transport.hpp"
+#include "../merge_lib/backend_mpi.hpp"
 
 enum Tag {
     TAG_TASK_SORT = 1,
@@ -27,31 +32,39 @@ struct TaskCompare {
     }
 };
 
-void mergeSort(std::vector<int>& arr) {
-    if (arr.size() <= 1) return;
-    size_t mid = arr.size() / 2;
-    std::vector<int> left(arr.begin(), arr.begin() + mid);
-    std::vector<int> right(arr.begin() + mid, arr.end());
-    mergeSort(left);
-    mergeSort(right);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), arr.begin());
-}
+// Режим psrs: сортировка выборкой (PSRS), данные проходят через root
+// только при раздаче и финальном сборе
+void run_psrs(int rank, int size, std::size_t N) {
+    std::vector<int> data, data_std;
+    double t_std = 0.0;
 
-void send_vector(int dest, int tag, const std::vector<int>& data) {
-    int size = (int)data.size();
-    MPI_Send(&size, 1, MPI_INT, dest, tag, MPI_COMM_WORLD);
-    if (size > 0)
-        MPI_Send(data.data(), size, MPI_INT, dest, tag, MPI_COMM_WORLD);
-}
+    if (rank == 0) {
+        data.resize(N);
+        for (std::size_t i = 0; i < N; ++i) data[i] = rand() % N;
 
-std::vector<int> recv_vector(int src, int tag) {
-    MPI_Status status;
-    int size;
-    MPI_Recv(&size, 1, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    std::vector<int> data(size);
-    if (size > 0)
-        MPI_Recv(data.data(), size, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    return data;
+        data_std = data;
+        double t_start_std = MPI_Wtime();
+        std::sort(data_std.begin(), data_std.end());
+        t_std = MPI_Wtime() - t_start_std;
+    }
+
+    merge_lib::mpi_backend<> be;
+    be.mode = merge_lib::mpi_mode::sample_sort;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t_start_parallel = MPI_Wtime();
+    merge_lib::sort(data, be);
+    double t_parallel = MPI_Wtime() - t_start_parallel;
+
+    if (rank == 0) {
+        std::cout << "\n=== РЕЗУЛЬТАТЫ (PSRS) ===\n";
+        std::cout << "Размер массива: " << N << "\n";
+        std::cout << "MPI процессов:  " << size << "\n";
+        std::cout << "std::sort:      " << t_std << " сек\n";
+        std::cout << "Параллельно:    " << t_parallel << " сек\n\n";
+        std::cout << (data == data_std ? "Результат совпадает с std::sort\n"
+                                       : "Ошибка в результате сортировки\n");
+    }
 }
 
 int main(int argc, char** argv) {
@@ -60,14 +73,22 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    const int N = 2'000'000;
+    const std::size_t N = 2'000'000;
+
+    // mpirun -np P ./merge_mpi psrs
+    if (argc > 1 && std::string(argv[1]) == "psrs") {
+        run_psrs(rank, size, N);
+        MPI_Finalize();
+        return 0;
+    }
+
     double t_parallel = 0.0; 
     std::vector<std::vector<int>> results;
 
     if (rank == 0) {
         // MASTER 
         std::vector<int> data(N);
-        for (int i = 0; i < N; ++i) data[i] = rand() % N;
+        for (std::size_t i = 0; i < N; ++i) data[i] = rand() % N;
 
         // Измеряем std::sort 
         std::vector<int> data_std = data;
@@ -85,17 +106,18 @@ int main(int argc, char** argv) {
             std::priority_queue<Task, std::vector<Task>, TaskCompare> task_queue;
 
             // Этап 1: создаём задачи сортировки
-            int chunk_size = (data.size() + num_workers - 1) / num_workers;
-            for (int i = 0; i < (int)data.size(); i += chunk_size) {
+            std::size_t chunk_size = (data.size() + num_workers - 1) / num_workers;
+            for (std::size_t i = 0; i < data.size(); i += chunk_size) {
                 Task t;
                 t.type = TAG_TASK_SORT;
                 t.priority = 0; 
                 t.data1 = std::vector<int>(data.begin() + i,
-                                           data.begin() + std::min<int>(i + chunk_size, data.size()));
+                                           data.begin() + std::min(i + chunk_size, data.size()));
                 task_queue.push(t);
             }
 
             int active_workers = 0;
+            merge_lib::send_requests<int> pending;  // задачи уходят без ожидания
 
             while (!task_queue.empty() || active_workers > 0) {
                 MPI_Status status;
@@ -109,21 +131,23 @@ int main(int argc, char** argv) {
                         task_queue.pop();
 
                         if (t.type == TAG_TASK_SORT) {
-                            send_vector(w, TAG_TASK_SORT, t.data1);
+                            pending.isend(w, TAG_TASK_SORT, std::move(t.data1));
                         } else {
-                            send_vector(w, TAG_TASK_MERGE, t.data1);
-                            send_vector(w, TAG_TASK_MERGE, t.data2);
+                            pending.isend(w, TAG_TASK_MERGE, std::move(t.data1));
+                            pending.isend(w, TAG_TASK_MERGE, std::move(t.data2));
                         }
                         active_workers++;
                     }
                 }
 
+                pending.reap();
+
                 // Готовые результаты
                 int flag;
                 MPI_Iprobe(MPI_ANY_SOURCE, TAG_RESULT, MPI_COMM_WORLD, &flag, &status);
                 if (flag) {
                     int src = status.MPI_SOURCE;
-                    auto result = recv_vector(src, TAG_RESULT);
+                    auto result = merge_lib::recv_vector(src, TAG_RESULT);
                     results.push_back(result);
                     active_workers--;
 
@@ -145,6 +169,8 @@ int main(int argc, char** argv) {
                 }
             }
             
+            pending.wait_all();
+
             // Отправляем сигнал остановки всем воркерам
             for (int w = 1; w <= num_workers; ++w)
                 MPI_Send(nullptr, 0, MPI_INT, w, TAG_STOP, MPI_COMM_WORLD);
@@ -152,7 +178,7 @@ int main(int argc, char** argv) {
         } else {
             // --- РЕЖИМ: Одиночный процесс (size == 1) ---
             results.push_back(data); 
-            mergeSort(results[0]);
+            merge_lib::sort(results[0]);
         }
 
         t_parallel = MPI_Wtime() - t_start_parallel;
@@ -187,16 +213,17 @@ int main(int argc, char** argv) {
             }
 
             if (status.MPI_TAG == TAG_TASK_SORT) {
-                auto vec = recv_vector(0, TAG_TASK_SORT);
-                mergeSort(vec);
-                send_vector(0, TAG_RESULT, vec);
+                auto vec = merge_lib::recv_vector(0, TAG_TASK_SORT);
+                merge_lib::sort(vec);
+                merge_lib::send_vector(0, TAG_RESULT, vec);
             }
             else if (status.MPI_TAG == TAG_TASK_MERGE) {
-                auto left = recv_vector(0, TAG_TASK_MERGE);
-                auto right = recv_vector(0, TAG_TASK_MERGE);
+                auto left = merge_lib::recv_vector(0, TAG_TASK_MERGE);
+                auto right = merge_lib::recv_vector(0, TAG_TASK_MERGE);
                 std::vector<int> merged(left.size() + right.size());
-                std::merge(left.begin(), left.end(), right.begin(), right.end(), merged.begin());
-                send_vector(0, TAG_RESULT, merged);
+                merge_lib::merge_runs(left.data(), left.data() + left.size(), right.data(), right.data() + right.size(),
+                                      merged.data(), std::less<int>());
+                merge_lib::send_vector(0, TAG_RESULT, merged);
             }
         }
     }
@@ -2,67 +2,21 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 
-// Последовательная сортировка
-void mergeSortSequential(std::vector<int>& a, std::vector<int>& tmp, int l, int r) {
-    if (r - l <= 1) return;
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/backend_omp.hpp"
+#include "../merge_lib/radix_sort.hpp"
+#include "../merge_lib/numa.hpp"
+#include "../merge_lib/tuning.hpp"
 
-    int m = (l + r) / 2;
-    mergeSortSequential(a, tmp, l, m);
-    mergeSortSequential(a, tmp, m, r);
-
-    std::merge(a.begin() + l, a.begin() + m,
-               a.begin() + m, a.begin() + r,
-               tmp.begin() + l);
-    std::copy(tmp.begin() + l, tmp.begin() + r, a.begin() + l);
-}
-
-// Параллельная сортировка с задачами OpenMP
-void mergeSortParallel(std::vector<int>& a, std::vector<int>& tmp,
-                       int l, int r, int depth)
-{
-    if (r - l <= 1)
-        return;
-
-    // Порог для последовательной сортировки
-    const int THRESHOLD = 50000;
-
-    if (depth <= 0 || (r - l) < THRESHOLD) {
-        mergeSortSequential(a, tmp, l, r);
-        return;
-    }
-
-    int m = (l + r) / 2;
-
-    // Левая задача
-    #pragma omp task shared(a, tmp) if (depth > 0)
-    {
-        mergeSortParallel(a, tmp, l, m, depth - 1);
-    }
-
-    // Правая задача
-    #pragma omp task shared(a, tmp) if (depth > 0)
-    {
-        mergeSortParallel(a, tmp, m, r, depth - 1);
-    }
-
-    #pragma omp taskwait
-
-    // Merge в tmp, затем copy back
-    std::merge(a.begin() + l, a.begin() + m,
-               a.begin() + m, a.begin() + r,
-               tmp.begin() + l);
-
-    std::copy(tmp.begin() + l, tmp.begin() + r, a.begin() + l);
-}
-
-int main() {
-    const int N = 2'000'000;
+// ./merge_omp [N] — N до 2^32 и больше, нужна память на 5 массивов по N int
+int main(int argc, char** argv) {
+    const std::size_t N = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
     const int threads = omp_get_max_threads();
-    const int MAX_DEPTH = 4;  // log2(потоки)
 
     std::vector<int> data(N);
-    for (int i = 0; i < N; i++)
+    for (std::size_t i = 0; i < N; i++)
         data[i] = rand() % N;
 
     // std::sort
@@ -76,23 +30,45 @@ int main() {
     std::vector<int> data_par = data;
     std::vector<int> tmp(N);
 
+    merge_lib::omp_backend be;
+    // cutoff / глубина / лист из профиля (bench/tune.cpp), иначе значения Params по умолчанию
+    merge_lib::Params params = merge_lib::tuned_params<int>("omp", threads);
+
     double t2 = omp_get_wtime();
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            mergeSortParallel(data_par, tmp, 0, N, MAX_DEPTH);
-        }
-    }
+    merge_lib::sort(data_par.data(), data_par.data() + N, tmp.data(), be, params);
     double t3 = omp_get_wtime();
 
+    // parallel LSD radix sort
+    std::vector<int> data_radix = data;
+
+    double t4 = omp_get_wtime();
+    merge_lib::radix_sort(data_radix.data(), tmp.data(), N, be);
+    double t5 = omp_get_wtime();
+
+    // NUMA: части по узлам, страницы data_numa/tmp_numa первыми касаются потоки узла
+    auto nodes = merge_lib::numa_nodes();
+    merge_lib::numa_buffer<int> data_numa(N), tmp_numa(N);
+
+    double t6 = omp_get_wtime();
+    auto numa_stats = merge_lib::numa_sort<merge_lib::omp_backend>(
+        data.data(), data_numa.data(), tmp_numa.data(), N, nodes, params);
+    double t7 = omp_get_wtime();
+
     std::cout << "Размер массива: " << N << "\n";
     std::cout << "Потоков:        " << threads << "\n";
+    std::cout << "Params:        cutoff " << params.cutoff << ", depth " << merge_lib::resolve_depth(params, threads)
+              << ", leaf " << merge_lib::to_string(params.leaf_algo) << "\n";
     std::cout << "std::sort:     " << result_time_sort << " sec\n";
     std::cout << "OpenMP merge:  " << (t3 - t2) << " sec\n";
+    std::cout << "OpenMP radix:  " << (t5 - t4) << " sec\n";
+    std::cout << "OpenMP NUMA:   " << (t7 - t6) << " sec (узлов: " << nodes.size() << ")\n";
+    for (auto& s : numa_stats)
+        std::cout << "  узел " << s.node << ": потоков " << s.threads << ", копия " << s.copy_gbs
+                  << " GB/s, сортировка " << s.sort_sec << " sec, слияние " << s.merge_gbs << " GB/s\n";
 
 
-    std::cout << (data_par == data_std
+    bool numa_ok = std::equal(data_std.begin(), data_std.end(), data_numa.data());
+    std::cout << (data_par == data_std && data_radix == data_std && numa_ok
                       ? "✓ correct\n"
                       : "✗ wrong\n");
 
@@ -3,58 +3,17 @@
 #include <algorithm>
 #include <iostream>
 
-// Последовательная сортировка по индексам (merge + copy-back)
-void mergeSortSequential(std::vector<int>& a, std::vector<int>& tmp, int l, int r) {
-    if (r - l <= 1) return;
-
-    int m = (l + r) / 2;
-
-    mergeSortSequential(a, tmp, l, m);
-    mergeSortSequential(a, tmp, m, r);
-
-    std::merge(a.begin() + l, a.begin() + m,
-               a.begin() + m, a.begin() + r,
-               tmp.begin() + l);
-
-    std::copy(tmp.begin() + l, tmp.begin() + r, a.begin() + l);
-}
-
-// Параллельная сортировка на TBB tasks
-void mergeSortTBB(std::vector<int>& a, std::vector<int>& tmp,
-                  int l, int r, int depth)
-{
-    if (r - l <= 1)
-        return;
-
-    const int THRESHOLD = 50000;
-
-    if (depth <= 0 || (r - l) < THRESHOLD) {
-        mergeSortSequential(a, tmp, l, r);
-        return;
-    }
-
-    int m = (l + r) / 2;
-
-    tbb::task_group tg;
-
-    tg.run([&]{ mergeSortTBB(a, tmp, l, m, depth - 1); });
-    tg.run([&]{ mergeSortTBB(a, tmp, m, r, depth - 1); });
-
-    tg.wait();
-
-    // merge into tmp, then copy back
-    std::merge(a.begin() + l, a.begin() + m,
-               a.begin() + m, a.begin() + r,
-               tmp.begin() + l);
-
-    std::copy(tmp.begin() + l, tmp.begin() + r, a.begin() + l);
-}
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/backend_tbb.hpp"
+#include "../merge_lib/radix_sort.hpp"
+#include "../merge_lib/numa.hpp"
+#include "../merge_lib/tuning.hpp"
 
 int main() {
-    const int N = 2'000'000;
+    const std::size_t N = 2'000'000;
 
     std::vector<int> data(N);
-    for (int i = 0; i < N; i++)
+    for (std::size_t i = 0; i < N; i++)
         data[i] = rand() % N;
 
     // std::sort
@@ -72,11 +31,13 @@ int main() {
         std::vector<int> data_par = data;
         std::vector<int> tmp(N);
 
-        int MAX_DEPTH = std::log2(threads) + 2;   // оптимально
+        merge_lib::tbb_backend be;
+        be.threads = threads;
+        merge_lib::Params params = merge_lib::tuned_params<int>("tbb", threads);
 
         auto ts = tbb::tick_count::now();
 
-        mergeSortTBB(data_par, tmp, 0, N, MAX_DEPTH);
+        merge_lib::sort(data_par.data(), data_par.data() + N, tmp.data(), be, params);
 
         auto te = tbb::tick_count::now();
 
@@ -84,7 +45,37 @@ int main() {
                   << ": " << (te - ts).seconds() << " сек,  "
                   << (data_par == data_std ? "✓ корректно" : "✗ ошибка")
                   << "\n";
+
+        std::vector<int> data_radix = data;
+        merge_lib::tbb_backend radix_be;
+        radix_be.threads = threads;   // число блоков гистограмм
+
+        auto rs = tbb::tick_count::now();
+        merge_lib::radix_sort(data_radix.data(), tmp.data(), N, radix_be);
+        auto re = tbb::tick_count::now();
+
+        std::cout << "TBB radix, threads = " << threads
+                  << ": " << (re - rs).seconds() << " сек,  "
+                  << (data_radix == data_std ? "✓ корректно" : "✗ ошибка")
+                  << "\n";
     }
 
+    // NUMA: по арене TBB на узел, части data/tmp первыми касаются потоки узла
+    auto nodes = merge_lib::numa_nodes();
+    merge_lib::numa_buffer<int> data_numa(N), tmp_numa(N);
+
+    auto ns = tbb::tick_count::now();
+    auto numa_stats = merge_lib::numa_sort<merge_lib::tbb_backend>(
+        data.data(), data_numa.data(), tmp_numa.data(), N, nodes);
+    auto ne = tbb::tick_count::now();
+
+    std::cout << "\nTBB NUMA, узлов = " << nodes.size()
+              << ": " << (ne - ns).seconds() << " сек,  "
+              << (std::equal(data_std.begin(), data_std.end(), data_numa.data()) ? "✓ корректно" : "✗ ошибка")
+              << "\n";
+    for (auto& s : numa_stats)
+        std::cout << "  узел " << s.node << ": потоков " << s.threads << ", копия " << s.copy_gbs
+                  << " GB/s, сортировка " << s.sort_sec << " сек, слияние " << s.merge_gbs << " GB/s\n";
+
     return 0;
 }
@@ -6,6 +6,9 @@
 #include <numeric>
 #include <cstdlib>
 
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/mpi_transport.hpp"
+
 enum Tag {
     TAG_TASK_SORT = 1,
     TAG_TASK_MERGE,
@@ -26,45 +29,18 @@ struct TaskCompare {
     }
 };
 
-void mergeSort(std::vector<int>& arr) {
-    if (arr.size() <= 1) return;
-    size_t mid = arr.size() / 2;
-    std::vector<int> left(arr.begin(), arr.begin() + mid);
-    std::vector<int> right(arr.begin() + mid, arr.end());
-    mergeSort(left);
-    mergeSort(right);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), arr.begin());
-}
-
-void send_vector(int dest, int tag, const std::vector<int>& data) {
-    int size = data.size();
-    MPI_Send(&size, 1, MPI_INT, dest, tag, MPI_COMM_WORLD);
-    if (size > 0)
-        MPI_Send(data.data(), size, MPI_INT, dest, tag, MPI_COMM_WORLD);
-}
-
-std::vector<int> recv_vector(int src, int tag) {
-    MPI_Status status;
-    int size;
-    MPI_Recv(&size, 1, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    std::vector<int> data(size);
-    if (size > 0)
-        MPI_Recv(data.data(), size, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    return data;
-}
-
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    const int N = 2'000'000;
+    const std::size_t N = 2'000'000;
 
     if (rank == 0) {
         // MASTER 
         std::vector<int> data(N);
-        for (int i = 0; i < N; ++i) data[i] = rand() % N;
+        for (std::size_t i = 0; i < N; ++i) data[i] = rand() % N;
 
         // Измеряем std::sort 
         std::vector<int> data_std = data;
@@ -80,18 +56,19 @@ int main(int argc, char** argv) {
         std::priority_queue<Task, std::vector<Task>, TaskCompare> task_queue;
 
         // Этап 1: создаём задачи сортировки
-        int chunk_size = (data.size() + num_workers - 1) / num_workers;
-        for (int i = 0; i < (int)data.size(); i += chunk_size) {
+        std::size_t chunk_size = (data.size() + num_workers - 1) / num_workers;
+        for (std::size_t i = 0; i < data.size(); i += chunk_size) {
             Task t;
             t.type = TAG_TASK_SORT;
             t.priority = 0;
             t.data1 = std::vector<int>(data.begin() + i,
-                                       data.begin() + std::min<int>(i + chunk_size, data.size()));
+                                       data.begin() + std::min(i + chunk_size, data.size()));
             task_queue.push(t);
         }
 
         std::vector<std::vector<int>> results;
         int active_workers = 0;
+        merge_lib::send_requests<int> pending;  // задачи уходят без ожидания
 
         while (!task_queue.empty() || active_workers > 0) {
             MPI_Status status;
@@ -105,21 +82,23 @@ int main(int argc, char** argv) {
                     task_queue.pop();
 
                     if (t.type == TAG_TASK_SORT) {
-                        send_vector(w, TAG_TASK_SORT, t.data1);
+                        pending.isend(w, TAG_TASK_SORT, std::move(t.data1));
                     } else {
-                        send_vector(w, TAG_TASK_MERGE, t.data1);
-                        send_vector(w, TAG_TASK_MERGE, t.data2);
+                        pending.isend(w, TAG_TASK_MERGE, std::move(t.data1));
+                        pending.isend(w, TAG_TASK_MERGE, std::move(t.data2));
                     }
                     active_workers++;
                 }
             }
 
+            pending.reap();
+
             // Готовые результаты
             int flag;
             MPI_Iprobe(MPI_ANY_SOURCE, TAG_RESULT, MPI_COMM_WORLD, &flag, &status);
             if (flag) {
                 int src = status.MPI_SOURCE;
-                auto result = recv_vector(src, TAG_RESULT);
+                auto result = merge_lib::recv_vector(src, TAG_RESULT);
                 results.push_back(result);
                 active_workers--;
 
@@ -141,6 +120,8 @@ int main(int argc, char** argv) {
             }
         }
 
+        pending.wait_all();
+
         for (int w = 1; w <= num_workers; ++w)
             MPI_Send(nullptr, 0, MPI_INT, w, TAG_STOP, MPI_COMM_WORLD);
 
@@ -168,16 +149,17 @@ int main(int argc, char** argv) {
                 break;
 
             if (status.MPI_TAG == TAG_TASK_SORT) {
-                auto vec = recv_vector(0, TAG_TASK_SORT);
-                mergeSort(vec);
-                send_vector(0, TAG_RESULT, vec);
+                auto vec = merge_lib::recv_vector(0, TAG_TASK_SORT);
+                merge_lib::sort(vec);
+                merge_lib::send_vector(0, TAG_RESULT, vec);
             }
             else if (status.MPI_TAG == TAG_TASK_MERGE) {
-                auto left = recv_vector(0, TAG_TASK_MERGE);
-                auto right = recv_vector(0, TAG_TASK_MERGE);
+                auto left = merge_lib::recv_vector(0, TAG_TASK_MERGE);
+                auto right = merge_lib::recv_vector(0, TAG_TASK_MERGE);
                 std::vector<int> merged(left.size() + right.size());
-                std::merge(left.begin(), left.end(), right.begin(), right.end(), merged.begin());
-                send_vector(0, TAG_RESULT, merged);
+                merge_lib::merge_runs(left.data(), left.data() + left.size(), right.data(), right.data() + right.size(),
+                                      merged.data(), std::less<int>());
+                merge_lib::send_vector(0, TAG_RESULT, merged);
             }
         }
     }
@@ -4,21 +4,15 @@
 #include <algorithm>
 #include <cstdlib>
 
-void mergeSort(std::vector<int>& arr) {
-    if (arr.size() <= 1) return;
-    size_t mid = arr.size() / 2;
-    std::vector<int> left(arr.begin(), arr.begin() + mid);
-    std::vector<int> right(arr.begin() + mid, arr.end());
-    mergeSort(left);
-    mergeSort(right);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), arr.begin());
-}
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/multiway_merge.hpp"
+#include "../merge_lib/backend_tbb.hpp"
 
 int main() {
-    const int N = 2'000'000; 
+    const std::size_t N = 2'000'000;
     std::vector<int> data(N);
 
-    for(int i = 0; i < N; i++)
+    for(std::size_t i = 0; i < N; i++)
         data[i] = rand() % N;
 
     // std::sort
@@ -35,40 +29,29 @@ int main() {
 
         std::vector<int> data_parallel = data;
         int grains = threads;
-        int chunk = (N + grains - 1) / grains;
+        std::size_t chunk = (N + grains - 1) / grains;
         std::vector<std::vector<int>> parts(grains);
 
         tbb::tick_count t_start = tbb::tick_count::now();
 
         tbb::parallel_for(0, grains, [&](int i){
-            int l = i * chunk;
-            int r = std::min(N, l + chunk);
+            std::size_t l = i * chunk;
+            std::size_t r = std::min(N, l + chunk);
             if(l >= N) return;
             parts[i] = std::vector<int>(data_parallel.begin() + l, data_parallel.begin() + r);
-            mergeSort(parts[i]);
+            merge_lib::sort(parts[i]);
         });
 
 
-        int active = grains;
-        while(active > 1){
-            int new_active = (active + 1) / 2;
-            std::vector<std::vector<int>> new_parts(new_active);
-
-            tbb::parallel_for(0, active/2, [&](int i){
-                int a = 2*i;
-                int b = a+1;
-                std::vector<int> merged(parts[a].size() + parts[b].size());
-                std::merge(parts[a].begin(), parts[a].end(),
-                           parts[b].begin(), parts[b].end(), merged.begin());
-                new_parts[i] = std::move(merged);
-            });
-
-            if(active % 2 == 1)
-                new_parts.back() = std::move(parts.back());
+        // Слияние всех серий за один проход: дерево проигравших, выход поделён между потоками
+        std::vector<merge_lib::run_ref<int>> runs;
+        for (auto& part : parts)
+            if (!part.empty()) runs.push_back({part.data(), part.data() + part.size()});
 
-            parts.swap(new_parts);
-            active = new_active;
-        }
+        std::vector<int> result(N);
+        merge_lib::tbb_backend be;
+        be.threads = threads;
+        merge_lib::multiway_merge(be, runs, result.data());
 
         tbb::tick_count t_end = tbb::tick_count::now();
         double T_parallel = (t_end - t_start).seconds();
@@ -76,7 +59,7 @@ int main() {
         std::cout << "TBB merge-sort, потоки = " << threads 
                   << ": " << T_parallel 
                   << " сек, "
-                  << (parts[0] == data_std ? "✓ корректно" : "✗ ошибка") 
+                  << (result == data_std ? "✓ корректно" : "✗ ошибка") 
                   << "\n";
     }
 
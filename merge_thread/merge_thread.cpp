@@ -1,79 +1,11 @@
 #include <iostream>
 #include <vector>
-#include <thread>
-#include <algorithm>
-#include <future>
-#include <random>
 #include <chrono>
+#include <cstdlib>
 
-void merge(std::vector<int>& arr, int left, int mid, int right) {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-    
-    std::vector<int> L(n1), R(n2);
-    
-    for (int i = 0; i < n1; i++)
-        L[i] = arr[left + i];
-    for (int j = 0; j < n2; j++)
-        R[j] = arr[mid + 1 + j];
-    
-    int i = 0, j = 0;
-    int k = left;
-    
-    while (i < n1 && j < n2) {
-        if (L[i] <= R[j]) {
-            arr[k] = L[i];
-            i++;
-        } else {
-            arr[k] = R[j];
-            j++;
-        }
-        k++;
-    }
-    
-    while (i < n1) {
-        arr[k] = L[i];
-        i++;
-        k++;
-    }
-    
-    while (j < n2) {
-        arr[k] = R[j];
-        j++;
-        k++;
-    }
-}
-
-void sequentialMergeSort(std::vector<int>& arr, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        sequentialMergeSort(arr, left, mid);
-        sequentialMergeSort(arr, mid + 1, right);
-        merge(arr, left, mid, right);
-    }
-}
-
-void parallelMergeSort(std::vector<int>& arr, int left, int right, int depth = 0) {
-    const int THRESHOLD = 10000;
-    const int MAX_DEPTH = 4;   
-    
-    if (left >= right) return;
-    
-    if (right - left < THRESHOLD || depth >= MAX_DEPTH) {
-        sequentialMergeSort(arr, left, right);
-        return;
-    }
-    
-    int mid = left + (right - left) / 2;
-    
-    std::thread leftThread(parallelMergeSort, std::ref(arr), left, mid, depth + 1);
-    std::thread rightThread(parallelMergeSort, std::ref(arr), mid + 1, right, depth + 1);
-    
-    leftThread.join();
-    rightThread.join();
-    
-    merge(arr, left, mid, right);
-}
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/backend_thread.hpp"
+#include "../merge_lib/tuning.hpp"
 
 int main()
 {
@@ -83,19 +15,51 @@ int main()
         data[i] = rand() % 10;
     }
     std::vector<int> data_seq = data;
+    std::vector<int> data_pool = data;
+    std::vector<int> data_merge = data;
+
+    merge_lib::thread_backend par;   // кража работы
+    merge_lib::pool_backend pool;    // общая очередь
+    merge_lib::serial_backend seq;
+
+    // cutoff / глубина / лист из профиля (bench/tune.cpp), иначе значения Params по умолчанию
+    merge_lib::Params params = merge_lib::tuned_params<int>("thread", par.concurrency());
+    std::cout << "Params: cutoff " << params.cutoff
+              << ", depth " << merge_lib::resolve_depth(params, par.concurrency())
+              << ", leaf " << merge_lib::to_string(params.leaf_algo) << "\n";
+    // у общей очереди свой профиль
+    merge_lib::Params params_pool = merge_lib::tuned_params<int>("pool", pool.concurrency());
 
     auto start_time = std::chrono::high_resolution_clock::now();
-    parallelMergeSort(data, 0, data.size() - 1);
+    merge_lib::sort_path path = merge_lib::sort(data, par, params);
     auto end_time = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration<double>(end_time - start_time);
 
-    std::cout << "Time Parall: " << duration.count() << "\n";
+    std::cout << "Time Parall: " << duration.count() << " (" << merge_lib::to_string(path) << ")\n";
+
+    auto start_pool = std::chrono::high_resolution_clock::now();
+    merge_lib::sort(data_pool, pool, params_pool);
+    auto end_pool = std::chrono::high_resolution_clock::now();
+    auto duration_pool = std::chrono::duration<double>(end_pool - start_pool);
+
+    std::cout << "Time Pool: " << duration_pool.count() << "\n";
 
     auto start_seq = std::chrono::high_resolution_clock::now();
-    sequentialMergeSort(data_seq, 0, data.size() - 1);
+    merge_lib::sort(data_seq, seq, params);
     auto end_seq = std::chrono::high_resolution_clock::now();
     auto duration_seq = std::chrono::duration<double>(end_seq - start_seq);
 
     std::cout << "Time Seq: " << duration_seq.count() << "\n";
+
+    // То же без проверки числа ключей: полное дерево слияний
+    merge_lib::Params params_merge = params;
+    params_merge.few_unique = false;
+
+    auto start_merge = std::chrono::high_resolution_clock::now();
+    merge_lib::sort(data_merge, par, params_merge);
+    auto end_merge = std::chrono::high_resolution_clock::now();
+    auto duration_merge = std::chrono::duration<double>(end_merge - start_merge);
+
+    std::cout << "Time Parall (merge only): " << duration_merge.count() << "\n";
 }
\ No newline at end of file
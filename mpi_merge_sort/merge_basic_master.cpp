@@ -2,37 +2,42 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <string>
+
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/mpi_transport.hpp"
 
 enum Tags {
     TAG_TASK_SORT = 1,
     TAG_TASK_MERGE,
     TAG_RESULT,
-    TAG_STOP
+    TAG_STOP,
+    TAG_PEER_MERGE
 };
 
-void mergeSort(std::vector<int>& arr) {
-    if (arr.size() <= 1) return;
-    size_t mid = arr.size() / 2;
-    std::vector<int> left(arr.begin(), arr.begin() + mid);
-    std::vector<int> right(arr.begin() + mid, arr.end());
-    mergeSort(left);
-    mergeSort(right);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), arr.begin());
-}
-
-void send_vector(int dest, int tag, const std::vector<int>& data) {
-    int size = data.size();
-    MPI_Send(&size, 1, MPI_INT, dest, tag, MPI_COMM_WORLD);
-    MPI_Send(data.data(), size, MPI_INT, dest, tag, MPI_COMM_WORLD);
-}
+// Режим tree: воркеры сливают серии друг с другом по биномиальному дереву.
+// На шаге k воркер w (кратный 2^(k+1)) принимает серию от w + 2^k,
+// воркер w = 2^k (mod 2^(k+1)) отправляет свою w - 2^k и выходит.
+// Master получает только итоговую серию от первого воркера.
+void worker_tree(int rank, int num_workers) {
+    int w = rank - 1;
+    auto run = merge_lib::recv_vector(0, TAG_TASK_SORT);
+    merge_lib::sort(run);
+
+    for (int step = 1; step < num_workers; step *= 2) {
+        if (w % (2 * step) == step) {
+            merge_lib::send_vector(rank - step, TAG_PEER_MERGE, run);
+            return;
+        }
+        if (w + step >= num_workers) continue;
 
-std::vector<int> recv_vector(int src, int tag) {
-    MPI_Status status;
-    int size;
-    MPI_Recv(&size, 1, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    std::vector<int> data(size);
-    MPI_Recv(data.data(), size, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    return data;
+        auto other = merge_lib::recv_vector(rank + step, TAG_PEER_MERGE);
+        std::vector<int> merged(run.size() + other.size());
+        merge_lib::merge_runs(run.data(), run.data() + run.size(), other.data(), other.data() + other.size(),
+                              merged.data(), std::less<int>());
+        run.swap(merged);
+    }
+    merge_lib::send_vector(0, TAG_RESULT, run);
 }
 
 int main(int argc, char** argv) {
@@ -42,43 +47,76 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    if (rank == 0) {
+    // mpirun -np P ./merge_basic_master tree
+    bool tree = argc > 1 && std::string(argv[1]) == "tree";
+
+    if (tree && rank > 0) {
+        worker_tree(rank, size - 1);
+    } else if (tree) {
+        // MASTER (tree): раздаёт части и ждёт одну итоговую серию
+        std::vector<int> data = {9, 4, 7, 3, 2, 8, 5, 1, 6, 0};
+        std::size_t n = data.size();
+        int num_workers = size - 1;
+        std::size_t chunk_size = (n + num_workers - 1) / num_workers;
+
+        merge_lib::send_requests<int> pending;
+        for (int i = 1; i <= num_workers; ++i) {
+            std::size_t begin = std::min((i - 1) * chunk_size, n);
+            std::size_t end = std::min(begin + chunk_size, n);
+            pending.isend(i, TAG_TASK_SORT, std::vector<int>(data.begin() + begin, data.begin() + end));
+        }
+
+        std::vector<int> sorted(n);
+        merge_lib::recv_into(sorted.data(), n, 1, TAG_RESULT);
+        pending.wait_all();
+
+        for (int x : sorted)
+            std::cout << x << ' ';
+        std::cout << std::endl;
+
+    } else if (rank == 0) {
         // MASTER
         std::vector<int> data = {9, 4, 7, 3, 2, 8, 5, 1, 6, 0};
-        int n = data.size();
+        std::size_t n = data.size();
         int num_workers = size - 1;
-        int chunk_size = (n + num_workers - 1) / num_workers;
+        std::size_t chunk_size = (n + num_workers - 1) / num_workers;
 
-        // Этап 1: Распределяем задачи сортировки
-        int offset = 0;
+        // Этап 1: Распределяем задачи сортировки (без ожидания каждой отправки)
+        merge_lib::send_requests<int> pending;
+        std::vector<std::size_t> part_sizes;
+        std::size_t offset = 0;
         for (int i = 1; i <= num_workers && offset < n; ++i) {
-            int end = std::min(offset + chunk_size, n);
-            std::vector<int> part(data.begin() + offset, data.begin() + end);
-            send_vector(i, TAG_TASK_SORT, part);
+            std::size_t end = std::min(offset + chunk_size, n);
+            pending.isend(i, TAG_TASK_SORT, std::vector<int>(data.begin() + offset, data.begin() + end));
+            part_sizes.push_back(end - offset);
             offset = end;
         }
 
-        // Этап 2: Сбор результатов сортировки
-        std::vector<std::vector<int>> sorted_parts;
-        for (int i = 1; i <= num_workers && i <= (int)data.size(); ++i) {
-            auto sorted_chunk = recv_vector(i, TAG_RESULT);
-            sorted_parts.push_back(std::move(sorted_chunk));
+        // Этап 2: Сбор результатов сортировки в заранее выделенные буферы
+        std::vector<std::vector<int>> sorted_parts(part_sizes.size());
+        for (std::size_t i = 0; i < part_sizes.size(); ++i) {
+            sorted_parts[i].resize(part_sizes[i]);
+            merge_lib::recv_into(sorted_parts[i].data(), part_sizes[i], i + 1, TAG_RESULT);
         }
+        pending.wait_all();
 
-        // Этап 3: Слияние по уровням
+        // Этап 3: Слияние по уровням: сначала раздаём все пары уровня, затем собираем
         while (sorted_parts.size() > 1) {
-            std::vector<std::vector<int>> new_level;
-            int i = 0;
-            for (; i + 1 < (int)sorted_parts.size(); i += 2) {
-                int worker = 1 + (i / 2) % num_workers;
-                // Отправляем две части для слияния
-                send_vector(worker, TAG_TASK_MERGE, sorted_parts[i]);
-                send_vector(worker, TAG_TASK_MERGE, sorted_parts[i + 1]);
-                auto merged = recv_vector(worker, TAG_RESULT);
-                new_level.push_back(std::move(merged));
+            std::size_t pairs = sorted_parts.size() / 2;
+            std::vector<std::vector<int>> new_level(pairs);
+            for (std::size_t k = 0; k < pairs; ++k) {
+                int worker = 1 + k % num_workers;
+                new_level[k].resize(sorted_parts[2 * k].size() + sorted_parts[2 * k + 1].size());
+                pending.isend(worker, TAG_TASK_MERGE, std::move(sorted_parts[2 * k]));
+                pending.isend(worker, TAG_TASK_MERGE, std::move(sorted_parts[2 * k + 1]));
+            }
+            for (std::size_t k = 0; k < pairs; ++k) {
+                int worker = 1 + k % num_workers;
+                merge_lib::recv_into(new_level[k].data(), new_level[k].size(), worker, TAG_RESULT);
             }
-            if (i < (int)sorted_parts.size())
-                new_level.push_back(sorted_parts[i]);
+            if (sorted_parts.size() % 2 == 1)
+                new_level.push_back(std::move(sorted_parts.back()));
+            pending.wait_all();
             sorted_parts.swap(new_level);
         }
 
@@ -102,18 +140,17 @@ int main(int argc, char** argv) {
                 break;
 
             if (status.MPI_TAG == TAG_TASK_SORT) {
-                auto vec = recv_vector(0, TAG_TASK_SORT);
-                mergeSort(vec);
-                send_vector(0, TAG_RESULT, vec);
+                auto vec = merge_lib::recv_vector(0, TAG_TASK_SORT);
+                merge_lib::sort(vec);
+                merge_lib::send_vector(0, TAG_RESULT, vec);
             }
             else if (status.MPI_TAG == TAG_TASK_MERGE) {
-                auto left = recv_vector(0, TAG_TASK_MERGE);
-                auto right = recv_vector(0, TAG_TASK_MERGE);
+                auto left = merge_lib::recv_vector(0, TAG_TASK_MERGE);
+                auto right = merge_lib::recv_vector(0, TAG_TASK_MERGE);
                 std::vector<int> merged(left.size() + right.size());
-                std::merge(left.begin(), left.end(),
-                           right.begin(), right.end(),
-                           merged.begin());
-                send_vector(0, TAG_RESULT, merged);
+                merge_lib::merge_runs(left.data(), left.data() + left.size(), right.data(), right.data() + right.size(),
+                                      merged.data(), std::less<int>());
+                merge_lib::send_vector(0, TAG_RESULT, merged);
             }
         }
     }
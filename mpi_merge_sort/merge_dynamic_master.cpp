@@ -1,11 +1,15 @@
 #include <mpi.h>
 #include <vector>
 #include <queue>
+#include <map>
 #include <iostream>
 #include <algorithm>
 #include <numeric>
 #include <cstdlib>
 
+#include "../merge_lib/merge_sort.hpp"
+#include "../merge_lib/mpi_transport.hpp"
+
 enum Tag {
     TAG_TASK_SORT = 1,
     TAG_TASK_MERGE,
@@ -13,11 +17,13 @@ enum Tag {
     TAG_STOP
 };
 
+// Задача покрывает чанки [lo, hi) исходного массива
 struct Task {
     int type;
     std::vector<int> data1;
     std::vector<int> data2;
     int priority;
+    int lo, hi;
 };
 
 struct TaskCompare {
@@ -26,32 +32,18 @@ struct TaskCompare {
     }
 };
 
-void mergeSort(std::vector<int>& arr) {
-    if (arr.size() <= 1) return;
-    size_t mid = arr.size() / 2;
-    std::vector<int> left(arr.begin(), arr.begin() + mid);
-    std::vector<int> right(arr.begin() + mid, arr.end());
-    mergeSort(left);
-    mergeSort(right);
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), arr.begin());
-}
-
-void send_vector(int dest, int tag, const std::vector<int>& data) {
-    int size = data.size();
-    MPI_Send(&size, 1, MPI_INT, dest, tag, MPI_COMM_WORLD);
-    if (size > 0)
-        MPI_Send(data.data(), size, MPI_INT, dest, tag, MPI_COMM_WORLD);
-}
+// Готовая отсортированная серия, покрывает чанки [lo, hi)
+struct Run {
+    int hi;
+    std::vector<int> data;
+};
 
-std::vector<int> recv_vector(int src, int tag) {
-    MPI_Status status;
-    int size;
-    MPI_Recv(&size, 1, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    std::vector<int> data(size);
-    if (size > 0)
-        MPI_Recv(data.data(), size, MPI_INT, src, tag, MPI_COMM_WORLD, &status);
-    return data;
-}
+// Состояние воркера: занят ли, какую задачу выполняет, куда придёт результат
+struct WorkerState {
+    bool busy = false;
+    int lo = 0, hi = 0;
+    std::vector<int> result;
+};
 
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
@@ -59,12 +51,12 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    const int N = 2'000'000;
+    const std::size_t N = 2'000'000;
 
     if (rank == 0) {
         // MASTER 
         std::vector<int> data(N);
-        for (int i = 0; i < N; ++i) data[i] = rand() % N;
+        for (std::size_t i = 0; i < N; ++i) data[i] = rand() % N;
 
         // Измеряем std::sort 
         std::vector<int> data_std = data;
@@ -80,67 +72,89 @@ int main(int argc, char** argv) {
         std::priority_queue<Task, std::vector<Task>, TaskCompare> task_queue;
 
         // Этап 1: создаём задачи сортировки
-        int chunk_size = (data.size() + num_workers - 1) / num_workers;
-        for (int i = 0; i < (int)data.size(); i += chunk_size) {
+        std::size_t chunk_size = (data.size() + num_workers - 1) / num_workers;
+        int chunks = 0;
+        for (std::size_t i = 0; i < data.size(); i += chunk_size, ++chunks) {
             Task t;
             t.type = TAG_TASK_SORT;
             t.priority = 0;
+            t.lo = chunks;
+            t.hi = chunks + 1;
             t.data1 = std::vector<int>(data.begin() + i,
-                                       data.begin() + std::min<int>(i + chunk_size, data.size()));
+                                       data.begin() + std::min(i + chunk_size, data.size()));
             task_queue.push(t);
         }
 
-        std::vector<std::vector<int>> results;
-        int active_workers = 0;
-
-        while (!task_queue.empty() || active_workers > 0) {
-            MPI_Status status;
+        std::vector<WorkerState> workers(num_workers + 1);
+        std::vector<MPI_Request> recv_requests(num_workers, MPI_REQUEST_NULL);
+        std::map<int, Run> runs;  // готовые серии по началу интервала
+        std::vector<int> result;
+        merge_lib::send_requests<int> pending;  // задачи уходят без ожидания
 
-            // Назначаем задачи свободным воркерам
+        while (true) {
+            // Назначаем задачи свободным воркерам по таблице состояний;
+            // размер результата известен заранее, приём ставится сразу
             for (int w = 1; w <= num_workers && !task_queue.empty(); ++w) {
-                int flag;
-                MPI_Iprobe(w, TAG_RESULT, MPI_COMM_WORLD, &flag, &status);
-                if (flag == 0) { // воркер свободен
-                    Task t = task_queue.top();
-                    task_queue.pop();
-
-                    if (t.type == TAG_TASK_SORT) {
-                        send_vector(w, TAG_TASK_SORT, t.data1);
-                    } else {
-                        send_vector(w, TAG_TASK_MERGE, t.data1);
-                        send_vector(w, TAG_TASK_MERGE, t.data2);
-                    }
-                    active_workers++;
+                if (workers[w].busy) continue;
+
+                Task t = task_queue.top();
+                task_queue.pop();
+
+                WorkerState& ws = workers[w];
+                ws.busy = true;
+                ws.lo = t.lo;
+                ws.hi = t.hi;
+                ws.result.resize(t.data1.size() + t.data2.size());
+                merge_lib::irecv_first(ws.result.data(), ws.result.size(), w, TAG_RESULT,
+                                       MPI_COMM_WORLD, &recv_requests[w - 1]);
+
+                if (t.type == TAG_TASK_SORT) {
+                    pending.isend(w, TAG_TASK_SORT, std::move(t.data1));
+                } else {
+                    pending.isend(w, TAG_TASK_MERGE, std::move(t.data1));
+                    pending.isend(w, TAG_TASK_MERGE, std::move(t.data2));
                 }
             }
 
-            // Готовые результаты
-            int flag;
-            MPI_Iprobe(MPI_ANY_SOURCE, TAG_RESULT, MPI_COMM_WORLD, &flag, &status);
-            if (flag) {
-                int src = status.MPI_SOURCE;
-                auto result = recv_vector(src, TAG_RESULT);
-                results.push_back(result);
-                active_workers--;
-
-                // Создаём новые задачи merge, когда все sort выполнены
-                if (task_queue.empty() && active_workers == 0 && results.size() > 1) {
-                    std::vector<std::vector<int>> new_level;
-                    for (size_t i = 0; i + 1 < results.size(); i += 2) {
-                        Task merge_task;
-                        merge_task.type = TAG_TASK_MERGE;
-                        merge_task.priority = 1;
-                        merge_task.data1 = results[i];
-                        merge_task.data2 = results[i + 1];
-                        task_queue.push(merge_task);
-                    }
-                    if (results.size() % 2 == 1)
-                        new_level.push_back(results.back());
-                    results.swap(new_level);
-                }
+            // Ждём любой результат без активного опроса
+            int index;
+            MPI_Waitany(num_workers, recv_requests.data(), &index, MPI_STATUS_IGNORE);
+            pending.reap();
+
+            WorkerState& ws = workers[index + 1];
+            ws.busy = false;
+            // Серии длиннее одного сообщения дочитываются кусками
+            merge_lib::recv_rest(ws.result.data(), ws.result.size(), index + 1, TAG_RESULT);
+
+            if (ws.lo == 0 && ws.hi == chunks) {
+                result = std::move(ws.result);
+                break;
+            }
+
+            // Новая серия сразу сливается с соседней, если та уже готова
+            auto it = runs.emplace(ws.lo, Run{ws.hi, std::move(ws.result)}).first;
+            auto left = it, right = it;
+            if (it != runs.begin() && std::prev(it)->second.hi == it->first)
+                left = std::prev(it);
+            else if (runs.count(it->second.hi))
+                right = runs.find(it->second.hi);
+
+            if (left != right) {
+                Task merge_task;
+                merge_task.type = TAG_TASK_MERGE;
+                merge_task.priority = 1;
+                merge_task.lo = left->first;
+                merge_task.hi = right->second.hi;
+                merge_task.data1 = std::move(left->second.data);
+                merge_task.data2 = std::move(right->second.data);
+                task_queue.push(std::move(merge_task));
+                runs.erase(left);
+                runs.erase(right);
             }
         }
 
+        pending.wait_all();
+
         for (int w = 1; w <= num_workers; ++w)
             MPI_Send(nullptr, 0, MPI_INT, w, TAG_STOP, MPI_COMM_WORLD);
 
@@ -153,8 +167,8 @@ int main(int argc, char** argv) {
         std::cout << "std::sort:      " << t_std << " сек\n";
         std::cout << "Параллельно:    " << t_parallel << " сек\n\n";
 
-        if (!results.empty()) {
-            bool ok = (results[0] == data_std);
+        if (!result.empty()) {
+            bool ok = (result == data_std);
             std::cout << (ok ? "Результат совпадает с std::sort\n"
                              : "Ошибка в результате сортировки\n");
         }
@@ -168,16 +182,17 @@ int main(int argc, char** argv) {
                 break;
 
             if (status.MPI_TAG == TAG_TASK_SORT) {
-                auto vec = recv_vector(0, TAG_TASK_SORT);
-                mergeSort(vec);
-                send_vector(0, TAG_RESULT, vec);
+                auto vec = merge_lib::recv_vector(0, TAG_TASK_SORT);
+                merge_lib::sort(vec);
+                merge_lib::send_vector(0, TAG_RESULT, vec);
             }
             else if (status.MPI_TAG == TAG_TASK_MERGE) {
-                auto left = recv_vector(0, TAG_TASK_MERGE);
-                auto right = recv_vector(0, TAG_TASK_MERGE);
+                auto left = merge_lib::recv_vector(0, TAG_TASK_MERGE);
+                auto right = merge_lib::recv_vector(0, TAG_TASK_MERGE);
                 std::vector<int> merged(left.size() + right.size());
-                std::merge(left.begin(), left.end(), right.begin(), right.end(), merged.begin());
-                send_vector(0, TAG_RESULT, merged);
+                merge_lib::merge_runs(left.data(), left.data() + left.size(), right.data(), right.data() + right.size(),
+                                      merged.data(), std::less<int>());
+                merge_lib::send_vector(0, TAG_RESULT, merged);
             }
         }
     }